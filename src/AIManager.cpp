@@ -1,15 +1,61 @@
 #include "AIManager.h"
 #include "GameEngine.h"
 #include "Game.h"
+#include "Profiler.h"
+#include "Logger.h"
 
-#include <QTimer>
+#include <QRandomGenerator>
+#include <QtConcurrent>
 
-AIManager::AIManager(const GameEngine &gameEngine, Game *g, QObject *parent)
-    : QObject(parent), engine(gameEngine), game(g)
+namespace
 {
-    moveTimer = new QTimer(this);
-    moveTimer->callOnTimeout(this, &AIManager::moveAI);
+
+// a new error for every game, so that a lost line can't be replayed
+Evaluation blurred(const Difficulty &difficulty)
+{
+    Evaluation res;
+    res.setNoise(difficulty.noise, QRandomGenerator::global()->generate64());
+    return res;
+}
+
+}
+
+AIManager::AIManager(const GameEngine &gameEngine, Game *g, Kind kind, Difficulty::Level level,
+                     std::shared_ptr<AnalysisCache> cache, QObject *parent)
+    : QObject(parent), engine(gameEngine), game(g), difficulty(Difficulty::of(level)),
+      search(blurred(difficulty), kind == Kind::AlphaBeta ? difficulty.megabytes : 1),
+      cache(std::move(cache))
+{
+    qCInfo(lcAI, "AI level %s", qPrintable(Difficulty::name(level)));
+    if (kind == Kind::MonteCarlo)
+    {
+        Mcts::Settings settings;
+        settings.threads = difficulty.threads;
+        settings.memoryMegabytes = difficulty.megabytes;
+        mcts.reset(new Mcts(settings, blurred(difficulty)));
+    }
+    searchWatcher = new QFutureWatcher<Search::Result>(this);
+    connect(searchWatcher, &QFutureWatcher<Search::Result>::finished, this, &AIManager::searchFinished);
     connect(game, &Game::sendMessage, this, &AIManager::handleMessage);
+    // queued, so the next hop starts outside of the animator's own frame
+    connect(game, &Game::animationFinished, this, &AIManager::playHop, Qt::QueuedConnection);
+}
+
+AIManager::~AIManager()
+{
+    // the ticket makes the stop hold even for a search still queued, so this
+    // only waits for it to notice
+    search.stop();
+    if (mcts)
+        mcts->stop();
+    searchWatcher->waitForFinished();
+    saveCache();
+}
+
+void AIManager::saveCache()
+{
+    if (cache && !cache->save())
+        qCWarning(lcAI, "Can't save the analysis cache: %s", qPrintable(cache->errorString()));
 }
 
 void AIManager::handleMessage(QString message)
@@ -20,63 +66,100 @@ void AIManager::handleMessage(QString message)
 
     if (operation == "wait")
     {
-        qInfo("Calculate AI move");
-        calculatedMoves = calculateMoves();
-        if (calculatedMoves.empty())
-            return game->win();
-        std::reverse(calculatedMoves.begin(), calculatedMoves.end());
-        moveTimer->start(500);
-    }
-}
+        qCInfo(lcAI, "Calculate AI move");
+        auto gameEngineAI = engine;
 
-void AIManager::moveAI()
-{
-    auto move = calculatedMoves.pop_back_val();
-    game->move(move.S, move.E, false);
-    if (calculatedMoves.empty())
+        Search::Limits limits;
+        limits.depth = difficulty.depth;
+        limits.nodes = mcts ? difficulty.playouts : difficulty.nodes;
+        if (game->hasClock())
+        {
+            limits.time = game->remainingTime(0);
+            limits.increment = game->clockIncrement();
+        }
+        else
+            limits.moveTime = difficulty.moveTime;
+
+        // blurred levels would play better than they should with cached moves
+        AnalysisCache::Entry cached;
+        if (cache && !difficulty.noise && cache->probe(gameEngineAI, cached) &&
+            cached.depth >= std::min(limits.depth, Config::AI::CACHE_DEPTH))
+        {
+            qCInfo(lcAI, "Cached AI move");
+            Search::Result result;
+            result.best = cached.best;
+            result.score = cached.score;
+            result.depth = cached.depth;
+            searchWatcher->setFuture(QtConcurrent::run([result] {
+                return result;
+            }));
+            return;
+        }
+        // the search runs on the thread pool so the clocks keep ticking
+        auto history = game->history();
+        quint64 ticket = mcts ? mcts->ticket() : search.ticket();
+        searchWatcher->setFuture(QtConcurrent::run([this, gameEngineAI, limits, history, ticket] {
+            if (mcts)
+                return mcts->run(gameEngineAI, limits, ticket);
+            return search.run(gameEngineAI, limits, history, ticket);
+        }));
+    }
+    else if (operation == "finish")
     {
-        moveTimer->stop();
-        game->endMove(false);
+        search.stop();
+        if (mcts)
+            mcts->stop();
+        saveCache();
     }
 }
 
-vector<AIManager::Move> AIManager::calculateMoves() const
+void AIManager::searchFinished()
 {
-    auto gameEngineAI = engine;
-    gameEngineAI.changeRole();
-    bool hasNext = gameEngineAI.updateMovable();
-    if (!hasNext)
-        return {};
+    PROFILE_SCOPE("ai.play");
+    auto result = searchWatcher->result();
+    PROFILE_VALUE("ai.depth", result.depth);
+    PROFILE_VALUE("ai.searchTime", result.time);
+    if (mcts)
+        qCInfo(lcAI, "AI: tree depth %d, score %d, %lld playouts in %lld ms",
+              result.depth, result.score, result.nodes, result.time);
+    else
+        qCInfo(lcAI, "AI: depth %d, score %d, %lld + %lld quiescence nodes in %lld ms, %.1f%% of %lld cutoffs on the first move",
+              result.depth, result.score, result.nodes, result.qnodes, result.time,
+              result.ordering.firstMoveRate() * 100, result.ordering.cutoffs);
+    // only exact results of the real evaluation are worth keeping
+    if (cache && !mcts && !difficulty.noise && !result.best.isNull() && result.nodes)
+        cache->store(engine, AnalysisCache::Entry{result.best, result.score, result.depth});
+    if (engine.isFinished())
+        return;
 
-    SmallVector<Move, 10> moves;
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-        {
-            auto &piece = gameEngineAI.board.get(i, j);
-            if (piece.isMovable())
-            {
-                auto next = gameEngineAI.nextCells(i, j);
-                for (auto E : next)
-                    moves.push_back(Move{QPoint{i, j}, E});
-            }
-        }
+    if (result.best.isNull())
+        return game->win();
+    // one hop after the other, each once the board has shown the previous
+    // one, so the sounds follow the slide and the captured pieces fade at
+    // the end of it
+    hops = MoveGenerator::hops(engine, result.best);
+    nextHop = 1;
+    playHop();
+}
 
-    vector<Move> result;
-    Move move = moves[rand() % moves.size()];
-    QPoint S = move.S, E = move.E;
-    auto makeMove = [&] {
-        result.push_back(Move{QPoint(9 - S.x(), 9 - S.y()),
-                              QPoint(9 - E.x(), 9 - E.y())});
-        return gameEngineAI.move(S, E);
-    };
-    while (makeMove())
+void AIManager::playHop()
+{
+    if (nextHop == 0 || game->isAnimating())
+        return;
+    if (engine.isFinished())
     {
-        S = E;
-        auto next = gameEngineAI.nextCells(S.x(), S.y(), true);
-        if (next.empty())
-            break;
-        E = next.size() == 1 ? next.front() : next[rand() % next.size()];
+        nextHop = 0;
+        return;
     }
-
-    return result;
+    if (nextHop < hops.size())
+    {
+        game->move(hops[nextHop - 1], hops[nextHop], false);
+        ++nextHop;
+        if (game->isAnimating())
+            return;
+    }
+    if (nextHop < hops.size())
+        return playHop();
+    nextHop = 0;
+    game->endMove(false);
 }
@@ -1,33 +1,47 @@
 #pragma once
 
 #include <QObject>
-#include <QPoint>
-#include "Vector.h"
+#include <QFutureWatcher>
+#include <memory>
+#include "AnalysisCache.h"
+#include "Difficulty.h"
+#include "Mcts.h"
+#include "Search.h"
 
-class QTimer;
 class GameEngine;
 class Game;
 
 class AIManager : public QObject
 {
-    struct Move
+public:
+    enum class Kind
     {
-        QPoint S, E;
+        AlphaBeta,  // Search
+        MonteCarlo  // Mcts
     };
 
+private:
     const GameEngine &engine;
     Game *game = nullptr;
-    QTimer *moveTimer = nullptr;
-    vector<Move> calculatedMoves;
+    QFutureWatcher<Search::Result> *searchWatcher = nullptr;
+    Difficulty difficulty;
+    Search search;
+    std::unique_ptr<Mcts> mcts; // only for Kind::MonteCarlo
+    std::shared_ptr<AnalysisCache> cache;
+    FixedVector<QPoint, GameEngine::MaxCaptures + 1> hops; // of the move being shown, hops[nextHop - 1] is where the piece stands
+    size_t nextHop = 0;
 
 public:
-    AIManager(const GameEngine &gameEngine, Game *g, QObject *parent = nullptr);
-    void moveAI();
+    // the cache may be shared with other AIs or missing
+    AIManager(const GameEngine &gameEngine, Game *g, Kind kind, Difficulty::Level level,
+              std::shared_ptr<AnalysisCache> cache, QObject *parent = nullptr);
+    ~AIManager();
+
+private:
+    void saveCache();
 
 private slots:
     void handleMessage(QString message);
-
-private:
-    vector<Move> calculateMoves() const;
+    void searchFinished();
+    void playHop();
 };
-
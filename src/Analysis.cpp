@@ -0,0 +1,192 @@
+#include "Analysis.h"
+#include "Game.h"
+#include <QtConcurrent>
+
+AnalysisPanel::AnalysisPanel(QWidget *parent) :
+    Widget(parent), search(Evaluation(), Config::AI::HASH_MB)
+{
+    header = new QLabel;
+    lines = new QLabel;
+    lines->setWordWrap(true);
+    lines->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    lines->setTextFormat(Qt::RichText);
+
+    QVBoxLayout *layout = new QVBoxLayout;
+    layout->addWidget(header);
+    layout->addWidget(lines, 1);
+    layout->setSpacing(6);
+    layout->setMargin(8);
+    setLayout(layout);
+
+    setObjectName("AnalysisPanel");
+    setStyleSheet("#AnalysisPanel { background: " + Config::Colors::PRIMARY + "; }"
+                  "QLabel { color: white; font-size: 12px; }");
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    watcher = new QFutureWatcher<Search::Result>(this);
+    connect(watcher, &QFutureWatcher<Search::Result>::finished, this, &AnalysisPanel::searchFinished);
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &AnalysisPanel::refresh);
+
+    search.setInfoCallback([this](const Search::Result &result) {
+        QMutexLocker locker(&mutex);
+        if (discarding)
+            return;
+        latest = result;
+        changed = true;
+    });
+}
+
+AnalysisPanel::~AnalysisPanel()
+{
+    // the task uses this panel; cancelled, it ends at its next node
+    stop();
+    watcher->waitForFinished();
+}
+
+void AnalysisPanel::analyze(const GameEngine &engine)
+{
+    stop();
+    {
+        QMutexLocker locker(&mutex);
+        latest = Search::Result{};
+        changed = true;
+        discarding = watcher->isRunning();
+    }
+    if (engine.isFinished())
+    {
+        refresh();
+        return;
+    }
+
+    pending = engine;
+    hasPending = true;
+    if (!watcher->isRunning())
+        start();
+}
+
+void AnalysisPanel::start()
+{
+    hasPending = false;
+    {
+        QMutexLocker locker(&mutex);
+        discarding = false;
+    }
+    auto root = pending;
+    mirrored = root.role() == 1;
+
+    Search::Limits limits;
+    limits.depth = MoveOrdering::MaxPly;
+    limits.multiPV = Config::AI::ANALYSIS_LINES;
+    quint64 ticket = search.ticket();
+    watcher->setFuture(QtConcurrent::run([this, root, limits, ticket] {
+        return search.run(root, limits, GameHistory(), ticket);
+    }));
+    elapsed.start();
+    refreshTimer->start(Config::AI::ANALYSIS_REFRESH);
+    refresh();
+}
+
+void AnalysisPanel::searchFinished()
+{
+    if (hasPending)
+        start();
+}
+
+void AnalysisPanel::stop()
+{
+    hasPending = false;
+    search.stop();
+    refreshTimer->stop();
+}
+
+void AnalysisPanel::refresh()
+{
+    if (watcher->isFinished())
+        refreshTimer->stop();
+
+    qint64 nodes = search.progress();
+    qint64 time = std::max<qint64>(elapsed.elapsed(), 1);
+
+    QMutexLocker locker(&mutex);
+    header->setText(QString("Depth %1   %2 kN/s")
+                    .arg(latest.depth)
+                    .arg(nodes / time));
+    if (!changed)
+        return;
+    changed = false;
+
+    QString text;
+    for (auto &line : latest.lines)
+    {
+        text += QString("<p><b>%1</b> ").arg(formatScore(line.score));
+        for (size_t ply = 0; ply < line.pv.size(); ++ply)
+            text += notation(line.pv[ply]) + " ";
+        text += "</p>";
+    }
+    lines->setText(text);
+}
+
+// standard numbering of the dark squares, 1 at the top left as the board is shown
+QString AnalysisPanel::notation(const Move &move) const
+{
+    auto square = [this](QPoint p) {
+        int x = mirrored ? GameEngine::Size - 1 - p.x() : p.x();
+        int y = mirrored ? GameEngine::Size - 1 - p.y() : p.y();
+        return x * (GameEngine::Size / 2) + y / 2 + 1;
+    };
+    return QString("%1%2%3")
+            .arg(square(move.from()))
+            .arg(move.captured ? "x" : "-")
+            .arg(square(move.to()));
+}
+
+QString AnalysisPanel::formatScore(int score) const
+{
+    if (score > Search::MateBound)
+        return QString("Win in %1").arg((Search::Mate - score + 1) / 2);
+    if (score < -Search::MateBound)
+        return QString("Loss in %1").arg((Search::Mate + score) / 2);
+    return QString("%1%2").arg(score >= 0 ? "+" : "").arg(score / 100.0, 0, 'f', 2);
+}
+
+AnalysisDialog::AnalysisDialog(const GameEngine &engine, QWidget *parent) :
+    QDialog(parent), gameEngine(engine)
+{
+    board = new Board(gameEngine);
+    panel = new AnalysisPanel;
+
+    Widget *sidebar = new Widget;
+    QVBoxLayout *sidebarLayout = new QVBoxLayout;
+    sidebarLayout->addWidget(panel);
+    sidebarLayout->setMargin(4);
+    sidebar->setLayout(sidebarLayout);
+    sidebar->setObjectName("AnalysisSidebar");
+    sidebar->setStyleSheet("#AnalysisSidebar{"
+                           "border: 4px solid " + Config::Colors::BORDER + ";"
+                           "}");
+    sidebar->setFixedWidth(200);
+
+    QHBoxLayout *layout = new QHBoxLayout;
+    layout->addWidget(board);
+    layout->addWidget(sidebar);
+    layout->setMargin(10);
+    layout->setSpacing(10);
+    setLayout(layout);
+
+    setWindowFlags(Qt::Window
+                     | Qt::WindowSystemMenuHint
+                     | Qt::WindowMinimizeButtonHint
+                     | Qt::WindowCloseButtonHint);
+    setStyleSheet("QDialog { background: " + Config::Colors::BACKGROUND + "; }");
+    setFixedWidth(830);
+    setWindowTitle("Analysis");
+
+    panel->analyze(gameEngine);
+}
+
+void AnalysisDialog::closeEvent(QCloseEvent *event)
+{
+    panel->stop();
+    event->accept();
+}
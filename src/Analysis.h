@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QMutex>
+#include <QFutureWatcher>
+#include "Common.h"
+#include "GameEngine.h"
+#include "Search.h"
+
+class Board;
+
+// Sidebar panel showing the engine's view of a position. The search runs on
+// the thread pool until stopped; the panel only picks up its latest iteration
+// on a timer, so the GUI thread never waits for it. A new position cancels
+// the running search and starts once it has finished, dropping its result.
+class AnalysisPanel : public Widget
+{
+    Q_OBJECT
+
+public:
+    explicit AnalysisPanel(QWidget *parent = nullptr);
+    ~AnalysisPanel();
+
+    // analyses the side to move of the position, shown as seen by engine.role()
+    void analyze(const GameEngine &engine);
+    void stop();
+
+private slots:
+    void refresh();
+    void searchFinished();
+
+private:
+    void start();
+
+    QString notation(const Move &move) const;
+    QString formatScore(int score) const;
+
+    QLabel *header, *lines;
+    QTimer *refreshTimer;
+    QElapsedTimer elapsed;
+
+    Search search;
+    QFutureWatcher<Search::Result> *watcher;
+    bool mirrored = false; // as the board is shown to role 1
+    GameEngine pending;    // to analyse once the cancelled search is over
+    bool hasPending = false;
+
+    QMutex mutex; // guards latest, changed and discarding, written by the searching thread
+    Search::Result latest;
+    bool changed = false;
+    bool discarding = false; // the search is cancelled, its iterations are for another position
+};
+
+class AnalysisDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit AnalysisDialog(const GameEngine &engine, QWidget *parent = nullptr);
+
+private:
+    void closeEvent(QCloseEvent *event);
+
+    GameEngine gameEngine;
+    Board *board;
+    AnalysisPanel *panel;
+};
@@ -0,0 +1,244 @@
+#include "AnalysisCache.h"
+#include "TranspositionTable.h"
+#include <QLockFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+struct AnalysisCache::Header
+{
+    char magic[8];
+    quint32 version;
+    quint32 count;
+};
+
+struct AnalysisCache::Record
+{
+    uint64_t key;
+    uint64_t captured; // the best move, as in Move
+    int16_t score;
+    uint8_t depth;
+    uint8_t start, end, promotion;
+    uint8_t reserved[2];
+};
+
+static_assert(sizeof(AnalysisCache::Header) == 16, "the header is part of the file format");
+static_assert(sizeof(AnalysisCache::Record) == 24, "the records are part of the file format");
+
+namespace
+{
+
+using Header = AnalysisCache::Header;
+using Record = AnalysisCache::Record;
+
+const char Magic[8] = {'D', 'R', 'A', 'U', 'C', 'A', 'C', 'H'};
+
+// the records of a file's contents; a file of another version is empty, as
+// its keys may not be the ones of this one
+bool parse(const uchar *data, qint64 bytes, const Record *&records, qint64 &count)
+{
+    records = nullptr;
+    count = 0;
+    if (bytes == 0)
+        return true;
+    if (bytes < qint64(sizeof(Header)))
+        return false;
+    Header header;
+    memcpy(&header, data, sizeof(Header));
+    if (memcmp(header.magic, Magic, sizeof(Magic)) != 0)
+        return false;
+    if (header.version != AnalysisCache::Version)
+        return true;
+    if (bytes != qint64(sizeof(Header)) + qint64(header.count) * qint64(sizeof(Record)))
+        return false;
+    records = reinterpret_cast<const Record *>(data + sizeof(Header));
+    count = header.count;
+    return true;
+}
+
+Record toRecord(uint64_t key, const AnalysisCache::Entry &entry)
+{
+    Record res{};
+    res.key = key;
+    res.captured = entry.best.captured;
+    res.score = int16_t(std::max<int>(std::numeric_limits<int16_t>::min(),
+                                      std::min<int>(entry.score, std::numeric_limits<int16_t>::max())));
+    res.depth = uint8_t(std::max(0, std::min(entry.depth, 255)));
+    res.start = entry.best.start;
+    res.end = entry.best.end;
+    res.promotion = entry.best.promotion;
+    return res;
+}
+
+AnalysisCache::Entry toEntry(const Record &record)
+{
+    AnalysisCache::Entry res;
+    res.best.captured = record.captured;
+    res.best.start = record.start;
+    res.best.end = record.end;
+    res.best.promotion = record.promotion != 0;
+    res.score = record.score;
+    res.depth = record.depth;
+    return res;
+}
+
+}
+
+AnalysisCache::AnalysisCache(QString fileName)
+    : file(fileName)
+{
+
+}
+
+AnalysisCache::~AnalysisCache()
+{
+    close();
+}
+
+bool AnalysisCache::open()
+{
+    close();
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+        return false;
+    }
+    qint64 bytes = file.size();
+    mapped = bytes ? file.map(0, bytes) : nullptr;
+    if (bytes && !mapped)
+    {
+        error = file.errorString();
+        file.close();
+        return false;
+    }
+    if (!parse(mapped, bytes, records, count))
+    {
+        error = "not an analysis cache";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void AnalysisCache::close()
+{
+    if (mapped)
+        file.unmap(mapped);
+    mapped = nullptr;
+    records = nullptr;
+    count = 0;
+    file.close();
+}
+
+QString AnalysisCache::errorString() const
+{
+    return error;
+}
+
+qint64 AnalysisCache::size() const
+{
+    return count;
+}
+
+const AnalysisCache::Record *AnalysisCache::find(uint64_t key) const
+{
+    auto it = std::lower_bound(records, records + count, key, [](const Record &record, uint64_t key) {
+        return record.key < key;
+    });
+    return it != records + count && it->key == key ? it : nullptr;
+}
+
+bool AnalysisCache::probe(const GameEngine &engine, Entry &entry) const
+{
+    uint64_t key = TranspositionTable::hash(engine);
+    Entry res;
+    auto it = pending.constFind(key);
+    if (it != pending.constEnd())
+        res = *it;
+    else if (auto record = find(key))
+        res = toEntry(*record);
+    else
+        return false;
+
+    Arena::Scope scope;
+    auto moves = MoveGenerator::generate(engine);
+    if (std::find(moves.begin(), moves.end(), res.best) == moves.end())
+        return false;
+    entry = res;
+    return true;
+}
+
+void AnalysisCache::store(const GameEngine &engine, const Entry &entry)
+{
+    uint64_t key = TranspositionTable::hash(engine);
+    auto it = pending.find(key);
+    if (it == pending.end() || it->depth <= entry.depth)
+        pending[key] = entry;
+}
+
+bool AnalysisCache::save()
+{
+    if (pending.isEmpty())
+        return true;
+    QLockFile lock(file.fileName() + ".lock");
+    if (!lock.tryLock(LockTimeout))
+    {
+        error = "the cache is locked by another process";
+        return false;
+    }
+
+    // what is on disk now, with what other processes saved since open()
+    std::vector<Record> merged;
+    QFile current(file.fileName());
+    if (current.exists())
+    {
+        if (!current.open(QIODevice::ReadOnly))
+        {
+            error = current.errorString();
+            return false;
+        }
+        QByteArray data = current.readAll();
+        const Record *saved = nullptr;
+        qint64 savedCount = 0;
+        if (!parse(reinterpret_cast<const uchar *>(data.constData()), data.size(), saved, savedCount))
+        {
+            error = "not an analysis cache";
+            return false;
+        }
+        merged.assign(saved, saved + savedCount);
+    }
+    for (auto it = pending.constBegin(); it != pending.constEnd(); ++it)
+        merged.push_back(toRecord(it.key(), it.value()));
+    // the deepest result of every position first, then the others dropped
+    std::sort(merged.begin(), merged.end(), [](const Record &a, const Record &b) {
+        return a.key != b.key ? a.key < b.key : a.depth > b.depth;
+    });
+    merged.erase(std::unique(merged.begin(), merged.end(), [](const Record &a, const Record &b) {
+        return a.key == b.key;
+    }), merged.end());
+
+    Header header;
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.count = quint32(merged.size());
+    QSaveFile out(file.fileName());
+    if (out.open(QIODevice::WriteOnly))
+    {
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(merged.data()), qint64(merged.size() * sizeof(Record)));
+    }
+    // unmapped before the rename, which some systems refuse over a mapped file
+    close();
+    if (!out.commit())
+    {
+        error = out.errorString();
+        open();
+        return false;
+    }
+    pending.clear();
+    return open();
+}
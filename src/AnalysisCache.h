@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <QFile>
+#include <QHash>
+#include "MoveGenerator.h"
+
+// Results of finished searches kept on disk across sessions, keyed by the
+// hash of the position (TranspositionTable::hash). The file is a header and
+// the records sorted by key, mapped read-only by open() and searched in
+// place. New results wait in memory until save(), which merges them into
+// what is on disk at that moment under a lock file, keeping the deeper
+// result of a position, and replaces the file in one rename. Any number of
+// processes can share a file that way.
+//
+// probe() may be called from several threads while nothing is stored;
+// everything else belongs to one thread.
+class AnalysisCache
+{
+public:
+    struct Entry
+    {
+        Move best;
+        int score = 0; // for the side to move
+        int depth = 0;
+    };
+
+    // the file format, see AnalysisCache.cpp
+    struct Header;
+    struct Record;
+
+    static constexpr quint32 Version = 1;
+    static constexpr int LockTimeout = 5000; // ms to wait for another process to save
+
+    explicit AnalysisCache(QString fileName);
+    ~AnalysisCache();
+
+    bool open(); // a missing file is an empty cache
+    void close();
+    QString errorString() const;
+    qint64 size() const; // results on disk
+
+    // false if the position isn't known or its move isn't legal there, which
+    // a collision of the hashes would give
+    bool probe(const GameEngine &engine, Entry &entry) const;
+    void store(const GameEngine &engine, const Entry &entry);
+    bool save();
+
+private:
+    const Record *find(uint64_t key) const;
+
+    QFile file;
+    QString error;
+    uchar *mapped = nullptr;
+    const Record *records = nullptr;
+    qint64 count = 0;
+    QHash<quint64, Entry> pending;
+};
@@ -0,0 +1,134 @@
+#include "Animation.h"
+#include "Config.h"
+#include "Profiler.h"
+#include <QEasingCurve>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+
+BoardAnimator::BoardAnimator(QObject *parent) :
+    QObject(parent)
+{
+    clock = new QTimer(this);
+    clock->setTimerType(Qt::PreciseTimer);
+    clock->setInterval(Config::Animation::FRAME);
+    connect(clock, &QTimer::timeout, this, &BoardAnimator::tick);
+}
+
+void BoardAnimator::slide(QPoint from, QPoint to, Piece piece)
+{
+    for (auto &slide : slides)
+        if (slide.path.back() == from)
+        {
+            slide.path.push_back(to);
+            slide.piece = piece;
+            int backlog = int(slide.path.size()) - 1 - int(slide.progress);
+            if (backlog > Config::Animation::MAX_BACKLOG)
+                slide.progress = std::floor(slide.progress) + backlog - 1;
+            return;
+        }
+    if (!slides.empty())
+        finish();
+    slides.push_back(Slide{{from, to}, piece, 0});
+    start();
+}
+
+void BoardAnimator::fade(QPoint square, Piece piece)
+{
+    fades.push_back(Fade{square, piece, 0});
+    start();
+}
+
+void BoardAnimator::finish()
+{
+    if (!isRunning())
+        return;
+    auto dirty = area();
+    slides.clear();
+    fades.clear();
+    clock->stop();
+    emit frame(dirty);
+    emit finished();
+}
+
+bool BoardAnimator::isRunning() const
+{
+    return !slides.empty() || !fades.empty();
+}
+
+bool BoardAnimator::hides(int x, int y) const
+{
+    for (auto &slide : slides)
+        if (slide.path.back() == QPoint(x, y))
+            return true;
+    return false;
+}
+
+vector<BoardAnimator::Sprite> BoardAnimator::sprites() const
+{
+    vector<Sprite> res;
+    for (auto &fade : fades)
+        res.push_back(Sprite{QPointF(fade.square), fade.piece, 1 - fade.progress});
+    for (auto &slide : slides)
+        res.push_back(Sprite{position(slide), slide.piece, 1});
+    return res;
+}
+
+void BoardAnimator::start()
+{
+    if (clock->isActive())
+        return;
+    elapsed.start();
+    lastFrame = 0;
+    clock->start();
+}
+
+void BoardAnimator::tick()
+{
+    PROFILE_SCOPE("animation.frame");
+    qint64 now = elapsed.elapsed();
+    qreal dt = now - lastFrame;
+    lastFrame = now;
+    auto dirty = area();
+
+    for (auto &slide : slides)
+    {
+        // catch up when hops arrive faster than they are shown
+        int hops = int(slide.path.size()) - 1;
+        qreal speed = std::max<qreal>(1, (hops - slide.progress) / 2);
+        slide.progress = std::min<qreal>(hops, slide.progress + dt * speed / Config::Animation::HOP);
+    }
+    for (auto &fade : fades)
+        fade.progress = std::min<qreal>(1, fade.progress + dt / Config::Animation::FADE);
+
+    dirty += area();
+    slides.erase(std::remove_if(slides.begin(), slides.end(), [](const Slide &slide) {
+        return slide.progress >= slide.path.size() - 1;
+    }), slides.end());
+    fades.erase(std::remove_if(fades.begin(), fades.end(), [](const Fade &fade) {
+        return fade.progress >= 1;
+    }), fades.end());
+    if (!isRunning())
+        clock->stop();
+    emit frame(dirty);
+    if (!isRunning())
+        emit finished();
+}
+
+// squares covered by the sprites, x being the column as on screen
+QVector<QRectF> BoardAnimator::area() const
+{
+    QVector<QRectF> res;
+    for (auto &sprite : sprites())
+        res.push_back(QRectF(sprite.square.y(), sprite.square.x(), 1, 1));
+    return res;
+}
+
+QPointF BoardAnimator::position(const Slide &slide)
+{
+    static const QEasingCurve curve(QEasingCurve::InOutQuad);
+    int hop = std::min(int(slide.progress), int(slide.path.size()) - 2);
+    qreal t = curve.valueForProgress(slide.progress - hop);
+    QPointF from(slide.path[hop]), to(slide.path[hop + 1]);
+    return from + (to - from) * t;
+}
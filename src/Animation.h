@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QPoint>
+#include <QRectF>
+#include <QVector>
+#include "Vector.h"
+
+class QTimer;
+
+// Piece animations of the board, all driven by one frame clock that only runs
+// while something moves. Positions are in squares, x being the row as in the
+// engine; frame() reports the area to repaint in the same units.
+//
+// Hops of the same piece are coalesced into one slide along the whole path,
+// which speeds up when hops pile up and jumps to its end when they pile up
+// too far, so the board never lags behind a fast opponent. A slide of another
+// piece finishes whatever was still sliding.
+class BoardAnimator : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Piece
+    {
+        int occupier;
+        bool king;
+    };
+
+    struct Sprite
+    {
+        QPointF square;
+        Piece piece;
+        qreal opacity;
+    };
+
+    explicit BoardAnimator(QObject *parent = nullptr);
+
+    void slide(QPoint from, QPoint to, Piece piece);
+    void fade(QPoint square, Piece piece);
+    void finish();
+    bool isRunning() const;
+
+    // the square a slide is heading to, which is already occupied in the engine
+    bool hides(int x, int y) const;
+    vector<Sprite> sprites() const;
+
+signals:
+    void frame(const QVector<QRectF> &area);
+    void finished(); // nothing moves any more, emitted after the last frame
+
+private slots:
+    void tick();
+
+private:
+    struct Slide
+    {
+        vector<QPoint> path;
+        Piece piece;
+        qreal progress; // in hops
+    };
+
+    struct Fade
+    {
+        QPoint square;
+        Piece piece;
+        qreal progress; // 0 to 1
+    };
+
+    void start();
+    QVector<QRectF> area() const;
+    static QPointF position(const Slide &slide);
+
+    QTimer *clock;
+    QElapsedTimer elapsed;
+    qint64 lastFrame = 0;
+    vector<Slide> slides;
+    vector<Fade> fades;
+};
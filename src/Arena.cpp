@@ -0,0 +1,84 @@
+#include "Arena.h"
+#include <algorithm>
+
+Arena &Arena::local()
+{
+    static thread_local Arena arena;
+    return arena;
+}
+
+char *Arena::top() const
+{
+    return blocks[current.block].memory.get() + current.offset;
+}
+
+void *Arena::allocate(size_t bytes, size_t alignment)
+{
+    for (;;)
+    {
+        if (current.block < blocks.size())
+        {
+            auto &block = blocks[current.block];
+            auto address = reinterpret_cast<uintptr_t>(block.memory.get()) + current.offset;
+            size_t padding = (alignment - address % alignment) % alignment;
+            if (current.offset + padding + bytes <= block.size)
+            {
+                current.offset += padding + bytes;
+                return reinterpret_cast<void *>(address + padding);
+            }
+            if (current.offset == 0 && block.size < bytes + alignment)
+                ; // a block of its own, below
+            else
+            {
+                // on to the next block, which has to be large enough
+                ++current.block;
+                current.offset = 0;
+                if (current.block < blocks.size() && blocks[current.block].size >= bytes + alignment)
+                    continue;
+            }
+        }
+        size_t size = std::max(BlockSize, bytes + alignment);
+        blocks.insert(blocks.begin() + std::min(current.block, blocks.size()),
+                      Block{std::unique_ptr<char[]>(new char[size]), size});
+        ++allocations;
+    }
+}
+
+bool Arena::extend(void *memory, size_t bytes, size_t newBytes)
+{
+    if (current.block >= blocks.size() || static_cast<char *>(memory) + bytes != top())
+        return false;
+    if (current.offset + newBytes - bytes > blocks[current.block].size)
+        return false;
+    current.offset += newBytes - bytes;
+    return true;
+}
+
+void Arena::release(void *memory, size_t bytes)
+{
+    if (current.block < blocks.size() && static_cast<char *>(memory) + bytes == top())
+        current.offset -= bytes;
+}
+
+Arena::Mark Arena::mark() const
+{
+    return current;
+}
+
+void Arena::rewind(Mark mark)
+{
+    current = mark;
+}
+
+size_t Arena::capacity() const
+{
+    size_t res = 0;
+    for (auto &block : blocks)
+        res += block.size;
+    return res;
+}
+
+int64_t Arena::blockAllocations() const
+{
+    return allocations;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Bump allocator for the scratch memory of the search, one per thread.
+// Allocating moves a pointer and nothing is freed on its own: a Scope rewinds
+// the arena to where it was when the scope was entered, which the search does
+// for every node and every iteration, so a node reuses the memory of the one
+// before. Blocks are kept once allocated, after the first few nodes the arena
+// doesn't touch the heap any more.
+class Arena
+{
+public:
+    struct Mark
+    {
+        size_t block = 0, offset = 0;
+    };
+
+    class Scope
+    {
+    public:
+        explicit Scope(Arena &arena = Arena::local()) : arena(arena), start(arena.mark()) {}
+        ~Scope() { arena.rewind(start); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Arena &arena;
+        Mark start;
+    };
+
+    static Arena &local(); // of the calling thread
+
+    void *allocate(size_t bytes, size_t alignment);
+    // grows the latest allocation if the block has room after it
+    bool extend(void *memory, size_t bytes, size_t newBytes);
+    // gives the latest allocation back, anything else waits for a rewind
+    void release(void *memory, size_t bytes);
+
+    Mark mark() const;
+    void rewind(Mark mark);
+
+    size_t capacity() const;     // bytes held in blocks
+    int64_t blockAllocations() const; // heap allocations made so far
+
+private:
+    static constexpr size_t BlockSize = 256 * 1024;
+
+    struct Block
+    {
+        std::unique_ptr<char[]> memory;
+        size_t size;
+    };
+
+    char *top() const;
+
+    std::vector<Block> blocks;
+    Mark current;
+    int64_t allocations = 0;
+};
+
+// A vector in an arena, for lists whose size is not bounded closely enough
+// for a FixedVector. It starts with the capacity it is given and grows in the
+// arena, in place while it is the latest allocation. It must not outlive the
+// Scope it was created in.
+template<typename T>
+class ArenaVector
+{
+public:
+    explicit ArenaVector(size_t capacity = 16, Arena &arena = Arena::local())
+        : arena(&arena), reserved(capacity)
+    {
+        items = static_cast<T *>(arena.allocate(capacity * sizeof(T), alignof(T)));
+    }
+
+    ArenaVector(ArenaVector &&other) noexcept
+        : arena(other.arena), items(other.items), count(other.count), reserved(other.reserved)
+    {
+        other.items = nullptr;
+        other.count = other.reserved = 0;
+    }
+
+    ArenaVector &operator=(ArenaVector &&other) noexcept
+    {
+        std::swap(arena, other.arena);
+        std::swap(items, other.items);
+        std::swap(count, other.count);
+        std::swap(reserved, other.reserved);
+        return *this;
+    }
+
+    ArenaVector(const ArenaVector &) = delete;
+    ArenaVector &operator=(const ArenaVector &) = delete;
+
+    ~ArenaVector()
+    {
+        clear();
+        if (items)
+            arena->release(items, reserved * sizeof(T));
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void push_back(const T &item) { emplace_back(item); }
+    void push_back(T &&item) { emplace_back(std::move(item)); }
+
+    template<typename... Args>
+    T &emplace_back(Args &&...args)
+    {
+        if (count == reserved)
+            grow();
+        return *new (items + count++) T(std::forward<Args>(args)...);
+    }
+
+    void pop_back() { items[--count].~T(); }
+
+    void clear()
+    {
+        while (count)
+            pop_back();
+    }
+
+    T &operator[](size_t i) { return items[i]; }
+    const T &operator[](size_t i) const { return items[i]; }
+    T &front() { return items[0]; }
+    const T &front() const { return items[0]; }
+    T &back() { return items[count - 1]; }
+    const T &back() const { return items[count - 1]; }
+
+    T *begin() { return items; }
+    T *end() { return items + count; }
+    const T *begin() const { return items; }
+    const T *end() const { return items + count; }
+
+private:
+    void grow()
+    {
+        size_t capacity = std::max<size_t>(reserved * 2, 16);
+        if (arena->extend(items, reserved * sizeof(T), capacity * sizeof(T)))
+        {
+            reserved = capacity;
+            return;
+        }
+        // the old storage stays behind until the scope ends
+        T *moved = static_cast<T *>(arena->allocate(capacity * sizeof(T), alignof(T)));
+        for (size_t i = 0; i < count; ++i)
+        {
+            new (moved + i) T(std::move(items[i]));
+            items[i].~T();
+        }
+        items = moved;
+        reserved = capacity;
+    }
+
+    Arena *arena;
+    T *items = nullptr;
+    size_t count = 0, reserved = 0;
+};
@@ -19,6 +19,8 @@
 **********************************************************************/ 
 
 #include "Common.h"
+#include "Profiler.h"
+#include "Logger.h"
 
 Widget::Widget(QWidget *parent) :
     QWidget(parent)
@@ -56,11 +58,44 @@ void Button::mousePressEvent(QMouseEvent *event)
         emit clicked(text());
 }
 
-void MsgHandler::handler(QtMsgType type, const QMessageLogContext&, const QString &msg)
+ProfilerOverlay::ProfilerOverlay(QWidget *parent) :
+    QLabel(parent)
 {
-    if (type >= Config::MSG_LEVEL)
+    QFont font("monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    font.setPointSize(9);
+    setFont(font);
+    setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    setMargin(8);
+    setStyleSheet("background: rgba(0, 0, 0, 180); color: white;");
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    hide();
+
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, &QTimer::timeout, this, &ProfilerOverlay::refresh);
+}
+
+void ProfilerOverlay::toggle()
+{
+    if (isVisible())
     {
-        const QString types[] = {"Debug", "Warning", "Critical", "Fatal", "Info"};
-        fprintf(stderr, "%s: %s\n", types[type].toStdString().c_str(), msg.toStdString().c_str());
+        refreshTimer->stop();
+        hide();
+        return;
     }
+    setGeometry(parentWidget()->rect());
+    refresh();
+    show();
+    raise();
+    refreshTimer->start(Config::PROFILER_REFRESH);
+}
+
+void ProfilerOverlay::refresh()
+{
+    setText(Profiler::report());
+}
+
+void MsgHandler::handler(QtMsgType type, const QMessageLogContext&, const QString &msg)
+{
+    Logger::instance().log(type, msg);
 }    
@@ -49,6 +49,24 @@ protected:
     void mousePressEvent(QMouseEvent *event);    
 };
 
+// live table of the profiler's metrics over its parent, see Profiler.h
+class ProfilerOverlay : public QLabel
+{
+    Q_OBJECT
+
+public:
+    explicit ProfilerOverlay(QWidget *parent);
+
+public slots:
+    void toggle();
+
+private slots:
+    void refresh();
+
+private:
+    QTimer *refreshTimer;
+};
+
 // message handler
 class MsgHandler 
 {
@@ -41,6 +41,7 @@
 namespace Config
 {
     const int MSG_LEVEL = 2;
+    const int PROFILER_REFRESH = 500; // ms between updates of the profiler overlay
     
     namespace Colors
     {
@@ -55,6 +56,26 @@ namespace Config
         const QString BACKGROUND = "#fafcfc"; 
         const QString BORDER = "#09afdf";
     }
+
+    namespace AI
+    {
+        const int HASH_MB = 16;
+        const bool MCTS = false; // Monte Carlo tree search instead of alpha-beta, see Mcts.h
+        const QString CACHE_FILE = "analysis.cache"; // in the application data directory, see AnalysisCache.h
+        const int CACHE_DEPTH = 12; // a cached result this deep is played without searching
+        const qint64 CLOCK_BASE = 5 * 60 * 1000;
+        const qint64 CLOCK_INCREMENT = 3 * 1000;
+        const int ANALYSIS_LINES = 3;
+        const int ANALYSIS_REFRESH = 250; // ms between updates of the analysis panel
+    }
+
+    namespace Animation
+    {
+        const int FRAME = 16; // ms
+        const int HOP = 150;
+        const int FADE = 200;
+        const int MAX_BACKLOG = 4; // hops a slide may lag behind before skipping
+    }
 }
 
 #endif
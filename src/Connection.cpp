@@ -19,6 +19,8 @@
 **********************************************************************/ 
 
 #include "Connection.h"
+#include "Profiler.h"
+#include "Logger.h"
 
 Connection::Connection(QTcpSocket *socket)
 {
@@ -28,17 +30,24 @@ Connection::Connection(QTcpSocket *socket)
 
 void Connection::recvMessage()
 {
-    QString msg = socket->readAll();
+    PROFILE_SCOPE("net.receive");
+    QByteArray data = socket->readAll();
+    PROFILE_COUNT("net.bytesReceived", data.size());
+    PROFILE_COUNT("net.reads", 1);
+    QString msg = data;
     for (int i = 0; i < msg.size(); ++i)
         if (msg[i] == '\n') msg[i] = ' ';
-    qInfo("READ %s", msg.toStdString().c_str());
+    qCInfo(lcNet, "READ %s", msg.toStdString().c_str());
     emit receivedMessage(msg);
 }
 
 void Connection::sendMessage(QString message)
 {
-    qInfo("WRITE %s", message.toStdString().c_str());
-    socket->write((message + "\n").toStdString().c_str());
+    PROFILE_SCOPE("net.send");
+    qCInfo(lcNet, "WRITE %s", message.toStdString().c_str());
+    qint64 written = socket->write((message + "\n").toStdString().c_str());
+    PROFILE_COUNT("net.bytesSent", written);
+    PROFILE_COUNT("net.writes", 1);
 }
 
 // in case of missed messages
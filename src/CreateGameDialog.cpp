@@ -21,11 +21,24 @@
 #include "CreateGameDialog.h"
 #include "ui_CreateGameDialog.h"
 
-CreateGameDialog::CreateGameDialog(QWidget *parent) :
+CreateGameDialog::CreateGameDialog(Kind kind, QWidget *parent) :
     QDialog(parent),
     ui(new Ui::CreateGameDialog)
 {
     ui->setupUi(this);
+    for (int level = 0; level < Difficulty::LevelCount; ++level)
+        ui->difficulty->addItem(Difficulty::name(Difficulty::Level(level)));
+    ui->difficulty->setCurrentIndex(Difficulty::Default);
+    if (kind == VersusAI)
+    {
+        setWindowTitle("Create Game vs. AI");
+        for (QWidget *widget : {ui->label_3, ui->nickname, ui->label, ui->ipList, ui->label_2, ui->port,
+                                ui->label_4, ui->modeStandard, ui->modeCustom, ui->label_5, ui->timeBase, ui->timeIncrement})
+            widget->hide();
+        return;
+    }
+    ui->label_6->hide();
+    ui->difficulty->hide();
     QList<QHostAddress> ipListAll = QNetworkInterface::allAddresses();
     ui->ipList->addItem(QHostAddress(QHostAddress::LocalHost).toString());    
     for (int i = 0; i < ipListAll.size(); ++i)
@@ -66,6 +79,14 @@ int CreateGameDialog::port()
     return ui->port->text().toInt();
 }
 
+TimeControl CreateGameDialog::timeControl()
+{
+    TimeControl res;
+    res.base = ui->timeBase->value() * 60 * 1000;
+    res.increment = ui->timeIncrement->value() * 1000;
+    return res;
+}
+
 QString CreateGameDialog::mode()
 {
     if (ui->modeCustom->isChecked())
@@ -73,3 +94,8 @@ QString CreateGameDialog::mode()
     else 
         return "Standard";
 }
+
+Difficulty::Level CreateGameDialog::difficulty()
+{
+    return Difficulty::Level(ui->difficulty->currentIndex());
+}
@@ -22,6 +22,8 @@
 #define CREATEGAMEDIALOG_H
 
 #include "Common.h"
+#include "Difficulty.h"
+#include "TimeManager.h"
 #include <QDialog>
 
 namespace Ui {
@@ -33,12 +35,20 @@ class CreateGameDialog : public QDialog
     Q_OBJECT
     
 public:
-    explicit CreateGameDialog(QWidget *parent = nullptr);
+    enum Kind
+    {
+        Online,
+        VersusAI // only asks for the level of the AI
+    };
+
+    explicit CreateGameDialog(Kind kind, QWidget *parent = nullptr);
     ~CreateGameDialog();
     QString ip();
     QString nickname();
     int port();
     QString mode();
+    TimeControl timeControl();
+    Difficulty::Level difficulty();
     
 private slots:
     void on_buttonCancel_clicked();
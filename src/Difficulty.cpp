@@ -0,0 +1,69 @@
+#include "Difficulty.h"
+#include "MoveOrdering.h"
+
+Difficulty Difficulty::of(Level level)
+{
+    Difficulty res;
+    switch (level)
+    {
+    case Beginner:
+        res.depth = 1;
+        res.nodes = 300;
+        res.playouts = 200;
+        res.moveTime = 200;
+        res.noise = 150;
+        res.megabytes = 1;
+        break;
+    case Easy:
+        res.depth = 2;
+        res.nodes = 2000;
+        res.playouts = 1000;
+        res.moveTime = 500;
+        res.noise = 80;
+        res.megabytes = 1;
+        break;
+    case Medium:
+        res.depth = 4;
+        res.nodes = 20000;
+        res.playouts = 5000;
+        res.moveTime = 1000;
+        res.noise = 30;
+        res.megabytes = 4;
+        break;
+    case Hard:
+        res.depth = 8;
+        res.nodes = 2000000;
+        res.playouts = 30000;
+        res.moveTime = 3000;
+        res.megabytes = 16;
+        break;
+    case Expert:
+    case LevelCount:
+        // as deep as the clock allows
+        res.depth = MoveOrdering::MaxPly;
+        res.moveTime = 5000;
+        res.megabytes = 32;
+        res.threads = 0;
+        break;
+    }
+    return res;
+}
+
+QString Difficulty::name(Level level)
+{
+    switch (level)
+    {
+    case Beginner:
+        return "Beginner";
+    case Easy:
+        return "Easy";
+    case Medium:
+        return "Medium";
+    case Hard:
+        return "Hard";
+    case Expert:
+    case LevelCount:
+        break;
+    }
+    return "Expert";
+}
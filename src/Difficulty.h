@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+// Levels of the AI as budgets for a move. The weak levels search less and
+// so cost less CPU, many of them fit on one host. Below Hard the evaluation
+// is also blurred (see Evaluation::setNoise): the error depends on the
+// position only, so a level misjudges a position the same way whenever it
+// meets it, instead of playing a random move now and then.
+//
+// The depth and node caps hold with a clock too; the move time replaces the
+// clock when a game has none.
+struct Difficulty
+{
+    enum Level
+    {
+        Beginner,
+        Easy,
+        Medium,
+        Hard,
+        Expert,
+        LevelCount
+    };
+    static constexpr Level Default = Expert; // the strength of the AI before there were levels
+
+    int depth = 0;
+    qint64 nodes = 0;    // of Search, 0 for unlimited
+    qint64 playouts = 0; // of Mcts, 0 for unlimited
+    qint64 moveTime = 0; // ms per move without a clock
+    int noise = 0;       // largest error added to the evaluation
+    int megabytes = 16;  // for the hash table of Search or the tree of Mcts
+    int threads = 1;     // of Mcts, 0 for one per core
+
+    static Difficulty of(Level level);
+    static QString name(Level level);
+};
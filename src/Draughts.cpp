@@ -20,11 +20,22 @@
 
 #include "Draughts.h"
 #include "AIManager.h"
+#include "Logger.h"
+
+#include <QDir>
+#include <QStandardPaths>
 
 Draughts::Draughts(QWidget *parent) : 
     QDialog(parent)
 {
+    Logger::setLevel(Config::MSG_LEVEL);
     qInstallMessageHandler(MsgHandler::handler);  
+
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataPath);
+    cache = std::make_shared<AnalysisCache>(dataPath + "/" + Config::AI::CACHE_FILE);
+    if (!cache->open())
+        qCWarning(lcAI, "Can't open the analysis cache: %s", qPrintable(cache->errorString()));
     
     landing = new Landing; 
     pendingMsg = new PendingMsg;
@@ -51,10 +62,13 @@ Draughts::Draughts(QWidget *parent) :
     setStyleSheet("QDialog { background: " + Config::Colors::BACKGROUND + "; }");       
 }
 
-void Draughts::createGameVsAI(const GameEngine &engine)
+void Draughts::createGameVsAI(const GameEngine &engine, Difficulty::Level level)
 {
     mode = GameMode::versusAI;
     gameEngine = engine;
+    difficulty = level;
+    timeControl.base = Config::AI::CLOCK_BASE;
+    timeControl.increment = Config::AI::CLOCK_INCREMENT;
     nickname[0] = "You";
     nickname[1] = "AI";
     ip[0] = ip[1] = QString{};
@@ -75,9 +89,10 @@ void Draughts::returnToHome()
     stackedWidget->setCurrentIndex(0);
 }
 
-void Draughts::createGame(QString nickname, QString ip, int port, const GameEngine &engine)
+void Draughts::createGame(QString nickname, QString ip, int port, const GameEngine &engine, TimeControl timeControl)
 {
     mode = GameMode::online;
+    this->timeControl = timeControl;
     this->ip[0] = ip;
     this->nickname[0] = nickname;
     gameEngine = engine;
@@ -93,6 +108,7 @@ void Draughts::createGame(QString nickname, QString ip, int port, const GameEngi
 void Draughts::joinGame(QString nickname, QString ip, int port)
 {
     mode = GameMode::online;
+    timeControl = TimeControl{};
     this->nickname[0] = nickname;
     this->ip[1] = ip;
     side = Side::client;
@@ -109,7 +125,7 @@ void Draughts::clientJoined(QString ip)
 {
     this->ip[1] = ip;
     connection = new Connection(server->socket());  
-    qInfo("Client joined: %s", server->socket()->peerAddress().toString().toStdString().c_str());
+    qCInfo(lcNet, "Client joined: %s", server->socket()->peerAddress().toString().toStdString().c_str());
     connect(connection, &Connection::receivedMessage, this, &Draughts::handleMessage);
     connection->sendMessage(QString("server %1 %2").arg(nickname[0]).arg(this->ip[1]));
 }
@@ -125,28 +141,51 @@ void Draughts::handleMessage(QString message)
         if (operation == "client")
         {
             in >> nickname[1];
-            qInfo("Client's nickname is %s", nickname[1].toStdString().c_str());
+            qCInfo(lcNet, "Client's nickname is %s", nickname[1].toStdString().c_str());
             initGame();
         }
         else if (operation == "server")
         {
             in >> nickname[1] >> ip[0];
-            qInfo("Server's nickname is %s", nickname[1].toStdString().c_str());
+            qCInfo(lcNet, "Server's nickname is %s", nickname[1].toStdString().c_str());
             connection->sendMessage("client " + nickname[0]);       
         }
+        else if (operation == "clock")
+            in >> timeControl.base >> timeControl.increment;
+        else if (operation == "time")
+        {
+            qint64 time;
+            in >> time;
+            game->setRemainingTime(0, time);
+        }
         else if (operation == "start")
         {
-            gameEngine.readState(in.readAll());
+            if (!gameEngine.readState(in.readAll()))
+            {
+                qCWarning(lcNet, "Invalid position from the server, not started");
+                return;
+            }
             startGame();
         }
         else if (operation == "move")
         {
             int sx, sy, ex, ey;
             in >> sx >> sy >> ex >> ey;
-            game->move(QPoint(9 - sx, 9 - sy), QPoint(9 - ex, 9 - ey));
+            if (!game->isLegalHop(QPoint(sx, sy), QPoint(ex, ey)))
+            {
+                qCWarning(lcNet, "Illegal move from the opponent: %d %d %d %d", sx, sy, ex, ey);
+                return;
+            }
+            game->move(QPoint(sx, sy), QPoint(ex, ey));
         }
         else if (operation == "endMove")
+        {
+            // the whole move follows its hops, a peer that disagrees is out of sync
+            Move move;
+            if (Move::unpack(in.readAll(), move) && !(move == game->pendingMove()))
+                qCWarning(lcNet, "Opponent's move %s doesn't match its hops", qPrintable(move.pack()));
             game->endMove(false);
+        }
         else if (operation == "finish")
             game->win();
         else if (operation == "requestDraw")
@@ -192,18 +231,22 @@ void Draughts::startGame()
         }
     case GameMode::versusAI:
         {
-            AI = new AIManager(gameEngine, game, this);
+            AI = new AIManager(gameEngine, game, Config::AI::MCTS ? AIManager::Kind::MonteCarlo : AIManager::Kind::AlphaBeta,
+                               difficulty, cache, this);
             break;
         }
     }
 
     game->setWindowTitle(title);
+    game->setClock(timeControl, mode == GameMode::versusAI);
     game->start();
 }
 
 void Draughts::initGame()
 {
     hide();    
+    if (timeControl.isEnabled())
+        connection->sendMessage(QString("clock %1 %2").arg(timeControl.base).arg(timeControl.increment));
     connection->sendMessage("start " + gameEngine.state(true));
     startGame();
 }
@@ -28,6 +28,9 @@
 #include "Connection.h"
 #include "GameEngine.h"
 #include "Game.h"
+#include "Difficulty.h"
+#include "AnalysisCache.h"
+#include <memory>
 
 class AIManager;
 
@@ -39,8 +42,8 @@ public:
     explicit Draughts(QWidget *parent = nullptr);
     
 private slots:
-    void createGameVsAI(const GameEngine &engine);
-    void createGame(QString nickname, QString ip, int port, const GameEngine &engine);
+    void createGameVsAI(const GameEngine &engine, Difficulty::Level level);
+    void createGame(QString nickname, QString ip, int port, const GameEngine &engine, TimeControl timeControl);
     void joinGame(QString nickname, QString ip, int port);
     void handleMessage(QString message);
     void clientJoined(QString ip);
@@ -57,6 +60,9 @@ private:
     Connection *connection;
     AIManager *AI = nullptr;
     GameEngine gameEngine;
+    TimeControl timeControl;
+    Difficulty::Level difficulty = Difficulty::Default;
+    std::shared_ptr<AnalysisCache> cache; // of the AIs, saved by each of them
     Game *game;
     
     QString nickname[2], ip[2];
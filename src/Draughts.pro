@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui network multimedia
+QT       += core gui network multimedia concurrent
 CONFIG	 += c++17
 CONFIG	 += sanitizer sanitize_address
 
@@ -13,11 +13,11 @@ greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 TARGET = Draughts
 TEMPLATE = app
 
+include(Engine.pri)
 
 SOURCES += main.cpp \
     AIManager.cpp \
     Common.cpp \
-    GameEngine.cpp \
     Landing.cpp \
     Draughts.cpp \
     CreateGameDialog.cpp \
@@ -26,13 +26,16 @@ SOURCES += main.cpp \
     Client.cpp \
     Connection.cpp \
     Game.cpp \
-    Generator.cpp
+    Generator.cpp \
+    Analysis.cpp \
+    PieceSprites.cpp \
+    Animation.cpp \
+    Logger.cpp
 
 HEADERS  += \
     AIManager.h \
     Common.h \
     Config.h \
-    GameEngine.h \
     Landing.h \
     Draughts.h \
     CreateGameDialog.h \
@@ -42,8 +45,10 @@ HEADERS  += \
     Connection.h \
     Game.h \
     Generator.h \
-    Vector.h \
-    utils/SmallVector.h
+    Analysis.h \
+    PieceSprites.h \
+    Animation.h \
+    Logger.h
 
 FORMS    += \
     CreateGameDialog.ui \
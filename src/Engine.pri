@@ -0,0 +1,50 @@
+# Engine sources shared by the application and the command-line tools in tools/
+
+INCLUDEPATH += $$PWD
+
+# qmake CONFIG+=profile compiles in the PROFILE_* probes, see Profiler.h
+profile: DEFINES += DRAUGHTS_PROFILE
+
+SOURCES += \
+    $$PWD/Arena.cpp \
+    $$PWD/GameEngine.cpp \
+    $$PWD/Evaluation.cpp \
+    $$PWD/PositionFile.cpp \
+    $$PWD/RandomPositions.cpp \
+    $$PWD/Notation.cpp \
+    $$PWD/MoveGenerator.cpp \
+    $$PWD/GameHistory.cpp \
+    $$PWD/GeneratorCheck.cpp \
+    $$PWD/MoveOrdering.cpp \
+    $$PWD/TranspositionTable.cpp \
+    $$PWD/TimeManager.cpp \
+    $$PWD/Search.cpp \
+    $$PWD/AnalysisCache.cpp \
+    $$PWD/Mcts.cpp \
+    $$PWD/Difficulty.cpp \
+    $$PWD/Profiler.cpp
+
+HEADERS += \
+    $$PWD/Arena.h \
+    $$PWD/GameEngine.h \
+    $$PWD/Evaluation.h \
+    $$PWD/Geometry.h \
+    $$PWD/PositionFile.h \
+    $$PWD/RandomPositions.h \
+    $$PWD/Notation.h \
+    $$PWD/MoveGenerator.h \
+    $$PWD/GameHistory.h \
+    $$PWD/GeneratorCheck.h \
+    $$PWD/MoveOrdering.h \
+    $$PWD/TranspositionTable.h \
+    $$PWD/TimeManager.h \
+    $$PWD/Variants.h \
+    $$PWD/VariantPosition.h \
+    $$PWD/Search.h \
+    $$PWD/AnalysisCache.h \
+    $$PWD/Mcts.h \
+    $$PWD/Difficulty.h \
+    $$PWD/Profiler.h \
+    $$PWD/Random.h \
+    $$PWD/Vector.h \
+    $$PWD/utils/SmallVector.h
@@ -0,0 +1,115 @@
+#include "Evaluation.h"
+#include "GameEngine.h"
+#include "Random.h"
+#include "TranspositionTable.h"
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdlib>
+
+Evaluation::Evaluation(const Weights &weights)
+    : w(weights)
+{
+
+}
+
+Evaluation::Features Evaluation::features(const GameEngine &engine)
+{
+    Features f{};
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+        {
+            auto &cell = engine.board.get(i, j);
+            if (cell.isEmpty())
+                continue;
+            int sign = cell.occupier() == engine.whoseTurn() ? 1 : -1;
+            if (cell.isKing())
+            {
+                f[King] += sign;
+                continue;
+            }
+            // black men move towards row 0, white ones towards the last row
+            int advanced = cell.occupier() == 0 ? GameEngine::Size - 1 - i : i;
+            f[Man] += sign;
+            f[Advancement] += sign * advanced;
+            if (std::abs(2 * i - (GameEngine::Size - 1)) <= 3 && std::abs(2 * j - (GameEngine::Size - 1)) <= 3)
+                f[Center] += sign;
+            if (advanced == 0)
+                f[BackRank] += sign;
+            if (j == 0 || j == GameEngine::Size - 1)
+                f[Edge] += sign;
+        }
+    return f;
+}
+
+int Evaluation::score(const Features &features) const
+{
+    int res = 0;
+    for (int k = 0; k < FeatureCount; ++k)
+        res += w[k] * features[k];
+    return res;
+}
+
+int Evaluation::operator()(const GameEngine &engine) const
+{
+    int res = score(features(engine));
+    if (noise)
+    {
+        uint64_t z = mix64(TranspositionTable::hash(engine) ^ noiseSeed);
+        res += int(z % uint64_t(2 * noise + 1)) - noise;
+    }
+    return res;
+}
+
+const Evaluation::Weights &Evaluation::weights() const
+{
+    return w;
+}
+
+void Evaluation::setWeights(const Weights &weights)
+{
+    w = weights;
+}
+
+void Evaluation::setNoise(int amplitude, uint64_t seed)
+{
+    noise = std::max(amplitude, 0);
+    noiseSeed = seed;
+}
+
+QString Evaluation::featureName(int feature)
+{
+    const QString names[FeatureCount] = {"Man", "King", "Advancement", "Center", "BackRank", "Edge"};
+    return names[feature];
+}
+
+bool Evaluation::load(QString fileName)
+{
+    QFile f(fileName);
+    if (!f.open(QIODevice::ReadOnly))
+        return false;
+    QTextStream in(&f);
+    auto weights = w;
+    while (!in.atEnd())
+    {
+        QString name;
+        int value = 0;
+        in >> name >> value;
+        for (int k = 0; k < FeatureCount; ++k)
+            if (featureName(k) == name)
+                weights[k] = value;
+    }
+    w = weights;
+    return true;
+}
+
+bool Evaluation::save(QString fileName) const
+{
+    QFile f(fileName);
+    if (!f.open(QIODevice::WriteOnly))
+        return false;
+    QTextStream out(&f);
+    for (int k = 0; k < FeatureCount; ++k)
+        out << featureName(k) << " " << w[k] << "\n";
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <QString>
+
+class GameEngine;
+
+// Linear static evaluation. Every feature is counted as "mine minus opponent's"
+// from the point of view of engine.whoseTurn(), so the score is for the side
+// to move.
+class Evaluation
+{
+public:
+    enum Feature
+    {
+        Man,         // men on the board
+        King,        // kings on the board
+        Advancement, // rows advanced by men
+        Center,      // men on the eight central squares
+        BackRank,    // men still guarding the own promotion row
+        Edge,        // men on the side columns
+        FeatureCount
+    };
+
+    using Features = std::array<int, FeatureCount>;
+    using Weights = std::array<int, FeatureCount>;
+
+    static constexpr Weights defaultWeights = {100, 300, 2, 4, 5, -3};
+
+    explicit Evaluation(const Weights &weights = defaultWeights);
+
+    int operator()(const GameEngine &engine) const;
+    int score(const Features &features) const;
+    static Features features(const GameEngine &engine);
+
+    const Weights &weights() const;
+    void setWeights(const Weights &weights);
+    // adds an error of at most amplitude to every score, a function of the
+    // position and the seed so that it agrees with the transposition table;
+    // 0 turns it off
+    void setNoise(int amplitude, uint64_t seed = 0);
+
+    // text format: one "<feature name> <weight>" pair per line
+    bool load(QString fileName);
+    bool save(QString fileName) const;
+
+    static QString featureName(int feature);
+
+private:
+    Weights w;
+    int noise = 0;
+    uint64_t noiseSeed = 0;
+};
@@ -20,103 +20,210 @@
 
 #include "GameEngine.h"
 #include "Game.h"
+#include "Analysis.h"
+#include "PieceSprites.h"
+#include "Animation.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include <QShortcut>
 
-Cell::Cell(GameEngine &engine, QColor background, int x, int y, QWidget *parent) :
-    QLabel(parent), gameEngine(engine)
+namespace
 {
-    this->background = background;
-    this->x = x;
-    this->y = y;
-    this->focused = false;
-    this->highlighted = false;
+
+const int BOARD_MARGIN = 8; // border and padding around the squares
+
 }
 
-void Cell::paintEvent(QPaintEvent *)
+Board::Board(GameEngine &engine, QWidget *parent) :
+    Widget(parent), gameEngine(engine)
 {
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+            focused[i][j] = highlighted[i][j] = false;
+
+    animator = new BoardAnimator(this);
+    connect(animator, &BoardAnimator::frame, this, &Board::animationFrame);
+    connect(animator, &BoardAnimator::finished, this, &Board::animationFinished);
+
+    setStyleSheet("border: 4px solid " + Config::Colors::BORDER + ";");
+    
+    setFixedWidth(600);
+    setFixedHeight(600);
+}
+
+// the engine has black at the bottom, the view has the local player there
+QPoint Board::viewed(QPoint square) const
+{
+    return gameEngine.role() == 1 ? QPoint(GameEngine::Size - 1 - square.x(), GameEngine::Size - 1 - square.y()) : square;
+}
+
+QRect Board::cellRect(int x, int y) const
+{
+    QPoint view = viewed(QPoint(x, y));
+    x = view.x();
+    y = view.y();
+    QRect area = rect().adjusted(BOARD_MARGIN, BOARD_MARGIN, -BOARD_MARGIN, -BOARD_MARGIN);
+    int left = area.left() + y * area.width() / GameEngine::Size, right = area.left() + (y + 1) * area.width() / GameEngine::Size;
+    int top = area.top() + x * area.height() / GameEngine::Size, bottom = area.top() + (x + 1) * area.height() / GameEngine::Size;
+    return QRect(left, top, right - left, bottom - top);
+}
+
+// squares given as x the column and y the row of the engine's board
+QRectF Board::squaresRect(const QRectF &squares) const
+{
+    QRectF view = squares;
+    if (gameEngine.role() == 1)
+        view.moveTopLeft(QPointF(GameEngine::Size - squares.right(), GameEngine::Size - squares.bottom()));
+    QRectF area = QRectF(rect()).adjusted(BOARD_MARGIN, BOARD_MARGIN, -BOARD_MARGIN, -BOARD_MARGIN);
+    qreal w = area.width() / GameEngine::Size, h = area.height() / GameEngine::Size;
+    return QRectF(area.left() + view.left() * w, area.top() + view.top() * h,
+                  view.width() * w, view.height() * h);
+}
+
+QPoint Board::cellAt(QPoint pos) const
+{
+    QRect area = rect().adjusted(BOARD_MARGIN, BOARD_MARGIN, -BOARD_MARGIN, -BOARD_MARGIN);
+    if (!area.contains(pos))
+        return QPoint(-1, -1);
+    return viewed(QPoint((pos.y() - area.top()) * GameEngine::Size / area.height(), (pos.x() - area.left()) * GameEngine::Size / area.width()));
+}
+
+void Board::paintEvent(QPaintEvent *event)
+{
+    PROFILE_SCOPE("paint.board");
+    Widget::paintEvent(event);
+    int squares = 0;
+
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing, true);
     painter.setPen(Qt::NoPen);
-    painter.setBrush(QBrush(highlighted ? Config::Colors::CELL_NEXT : background));
-    painter.drawRect(0, 0, width(), height());
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+        {
+            QRect rect = cellRect(i, j);
+            if (!event->region().intersects(rect))
+                continue;
+            ++squares;
+            auto background = ((i + j) % 2) ? Config::Colors::CELL_DARK : Config::Colors::CELL_LIGHT;
+            painter.fillRect(rect, highlighted[i][j] ? Config::Colors::CELL_NEXT : background);
+
+            auto &cell = gameEngine.board.get(i, j);
+            if (!cell.isEmpty() && !animator->hides(i, j))
+                painter.drawPixmap(rect.topLeft(), PieceSprites::piece(cell.occupier(), cell.isKing(), focused[i][j],
+                                                                        rect.size(), devicePixelRatioF()));
+        }
 
-    auto &cell = gameEngine.board.get(x, y);
-    if (!cell.isEmpty()) // draw piece
+    for (auto &sprite : animator->sprites())
     {
-        const int margin = 7;
-        const int stroke = 5;
-        if (focused)
-            painter.setPen(QPen(Config::Colors::PIECE_FOCUSED, stroke));
-        auto occupier = cell.occupier();
-        if (occupier)
-            painter.setBrush(QBrush(Config::Colors::PIECE_LIGHT));
-        else
-            painter.setBrush(QBrush(Config::Colors::PIECE_DARK));
-        painter.drawEllipse(margin, margin, width() - margin * 2, height() - margin * 2);
-        if (cell.isKing())
+        QRectF rect = squaresRect(QRectF(sprite.square.y(), sprite.square.x(), 1, 1));
+        if (!event->region().intersects(rect.toAlignedRect()))
+            continue;
+        painter.setOpacity(sprite.opacity);
+        painter.drawPixmap(rect.topLeft(), PieceSprites::piece(sprite.piece.occupier, sprite.piece.king, false,
+                                                                rect.size().toSize(), devicePixelRatioF()));
+    }
+    PROFILE_VALUE("paint.squares", squares);
+}
+
+void Board::animationFrame(const QVector<QRectF> &area)
+{
+    for (auto &squares : area)
+        update(squaresRect(squares).toAlignedRect().adjusted(-1, -1, 1, 1));
+}
+
+void Board::refresh()
+{
+    auto &changes = gameEngine.changes();
+    if (changes.squares.all())
+    {
+        // a new position rather than a move
+        animator->finish();
+        captured.clear();
+        update();
+        gameEngine.clearChanges();
+        return;
+    }
+
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
         {
-            const int margin = 14;
-            painter.drawPixmap(margin, margin, width() - margin * 2, height() - margin * 2,
-                               occupier ? QPixmap(":/icons/king-light.png") : QPixmap(":/icons/king-dark.png"));
+            int index = GameEngine::Changes::index(i, j);
+            if (changes.captured[index])
+                captured[index] = gameEngine.board.get(i, j);
+            if (!changes.squares[index])
+                continue;
+            update(cellRect(i, j));
+            auto it = captured.find(index);
+            if (it != captured.end() && gameEngine.board.get(i, j).isEmpty())
+            {
+                animator->fade(QPoint(i, j), BoardAnimator::Piece{it->occupier(), it->isKing()});
+                captured.erase(it);
+            }
         }
+    if (changes.from.x() != -1)
+    {
+        auto &piece = gameEngine.board.get(changes.to.x(), changes.to.y());
+        animator->slide(changes.from, changes.to, BoardAnimator::Piece{piece.occupier(), piece.isKing()});
     }
+    gameEngine.clearChanges();
 }
 
-void Cell::setOccupier(int occupier, bool king)
+bool Board::isAnimating() const
 {
-    gameEngine.board.get(x, y) = GameEngine::Cell{occupier, king};
-    this->focused = this->highlighted = false;
-    update();
+    return animator->isRunning();
 }
 
-void Cell::setFocused(bool focused)
+void Board::setOccupier(int x, int y, int occupier, bool king)
 {
-    this->focused = focused;
-    update();
+    gameEngine.board.get(x, y) = GameEngine::Cell{occupier, king};
+    focused[x][y] = highlighted[x][y] = false;
+    update(cellRect(x, y));
 }
 
-void Cell::setHighlighted(bool highlighted)
+void Board::setFocused(int x, int y, bool focused)
 {
-    this->highlighted = highlighted;
-    update();
+    if (this->focused[x][y] == focused)
+        return;
+    this->focused[x][y] = focused;
+    update(cellRect(x, y));
 }
 
-bool Cell::isHighlighted() const
+void Board::setHighlighted(int x, int y, bool highlighted)
 {
-    return highlighted;
+    if (this->highlighted[x][y] == highlighted)
+        return;
+    this->highlighted[x][y] = highlighted;
+    update(cellRect(x, y));
 }
 
-void Cell::mousePressEvent(QMouseEvent *event)
+bool Board::isHighlighted(int x, int y) const
 {
-    if (event->button() == Qt::LeftButton)
-        emit clicked(x, y);
+    return highlighted[x][y];
 }
 
-Board::Board(GameEngine &engine, QWidget *parent) :
-    Widget(parent)
+void Board::clearMarks()
 {
-    QGridLayout *layout = new QGridLayout;    
-    
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
         {
-            auto background = ((i + j) % 2) ? Config::Colors::CELL_DARK : Config::Colors::CELL_LIGHT;
-            cell[i][j] = new Cell(engine, background, i, j);
-            layout->addWidget(cell[i][j], i, j);
+            setFocused(i, j, false);
+            setHighlighted(i, j, false);
         }
-                
-    layout->setSpacing(0);
-    layout->setMargin(4);
-    setLayout(layout);
-    
-    setStyleSheet("border: 4px solid " + Config::Colors::BORDER + ";");
-    
-    setFixedWidth(600);
-    setFixedHeight(600);
+}
+
+void Board::mousePressEvent(QMouseEvent *event)
+{
+    // the engine is always ahead of the animations, show where it is
+    animator->finish();
+    QPoint p = cellAt(event->pos());
+    if (event->button() == Qt::LeftButton && p.x() != -1)
+        emit clicked(p.x(), p.y());
 }
 
 GameSidebarPlayerStatus::GameSidebarPlayerStatus(int role, QWidget *parent) :
     QLabel(parent)
 {
+    this->role = role;
+    this->winner = false;
     pen = Qt::NoPen;
     if (role == 0)
         brush = QBrush(Config::Colors::PIECE_DARK);
@@ -136,15 +243,13 @@ void GameSidebarPlayerStatus::setActive(bool active)
 
 void GameSidebarPlayerStatus::setWinner()
 {        
-    if (brush == QBrush(Config::Colors::PIECE_DARK))
-        winner = QPixmap(":/icons/king-dark.png");
-    else
-        winner = QPixmap(":/icons/king-light.png");
+    winner = true;
     update();
 }
 
 void GameSidebarPlayerStatus::paintEvent(QPaintEvent *)
 {
+    PROFILE_SCOPE("paint.playerStatus");
     const int r = 30;
     const int rWinner = 20;  
     QPainter painter(this);
@@ -152,7 +257,9 @@ void GameSidebarPlayerStatus::paintEvent(QPaintEvent *)
     painter.setBrush(brush);
     painter.setPen(pen);
     painter.drawEllipse(QPoint(width() / 2, height() / 2), r, r);
-    painter.drawPixmap(width() / 2 - rWinner, height() / 2 - rWinner, 2 * rWinner, 2 * rWinner, winner);
+    if (winner)
+        painter.drawPixmap(width() / 2 - rWinner, height() / 2 - rWinner,
+                           PieceSprites::king(role, QSize(2 * rWinner, 2 * rWinner), devicePixelRatioF()));
 }
 
 QLabel* GameSidebarPlayer::renderText(QString text)
@@ -169,11 +276,15 @@ GameSidebarPlayer::GameSidebarPlayer(QString name, QString ip, int role, QWidget
     status = new GameSidebarPlayerStatus(role);
     this->name = renderText(name);
     this->ip = renderText(ip.isEmpty() ? ip : QString("IP: %1").arg(ip));
+    clock = renderText("");
+    clock->setStyleSheet(clock->styleSheet() + "font-size: 20px;");
+    clock->hide();
     
     QVBoxLayout *layout = new QVBoxLayout;
     layout->addWidget(status);
     layout->addWidget(this->name);
     layout->addWidget(this->ip);
+    layout->addWidget(clock);
     
     layout->setSpacing(0);
     layout->setMargin(4);
@@ -200,12 +311,14 @@ GameSidebarButtons::GameSidebarButtons(QWidget *parent) :
     buttonRequestDraw = renderButton("Request Draw");
     buttonResign = renderButton("Resign");
     buttonSound = renderButton("Sound: On");
+    buttonAnalysis = renderButton("Analysis: Off");
     
     QVBoxLayout *layout = new QVBoxLayout;
     layout->addStretch();
     layout->addWidget(buttonRequestDraw);
     layout->addWidget(buttonResign);
     layout->addWidget(buttonSound);
+    layout->addWidget(buttonAnalysis);
     layout->addStretch();
     layout->setContentsMargins(20, 4, 20, 4);
     layout->setSpacing(10);
@@ -225,10 +338,13 @@ GameSidebar::GameSidebar(QString name0, QString ip0, int role0, QString name1, Q
     player[0] = new GameSidebarPlayer(name0, ip0, role0);
     player[1] = new GameSidebarPlayer(name1, ip1, role1);
     buttons = new GameSidebarButtons();
+    analysis = new AnalysisPanel();
+    analysis->hide();
     
     QVBoxLayout *layout = new QVBoxLayout;
     layout->addWidget(player[0]);
     layout->addWidget(buttons);
+    layout->addWidget(analysis);
     layout->addWidget(player[1]);
     
     layout->setSpacing(0);
@@ -259,10 +375,17 @@ Game::Game(GameEngine &engine, QString name0, QString ip0, QString name1, QStrin
     connect(gameSidebar->buttons->buttonRequestDraw, &Button::clicked, this, &Game::requestDraw);
     connect(gameSidebar->buttons->buttonResign, &Button::clicked, this, &Game::resign);
     connect(gameSidebar->buttons->buttonSound, &Button::clicked, this, &Game::switchSound);
+    connect(gameSidebar->buttons->buttonAnalysis, &Button::clicked, this, &Game::switchAnalysis);
+
+    clockTicker = new QTimer(this);
+    connect(clockTicker, &QTimer::timeout, this, &Game::updateClocks);
+
+    profilerOverlay = new ProfilerOverlay(this);
+    connect(new QShortcut(QKeySequence(Qt::Key_F12), this), &QShortcut::activated,
+            profilerOverlay, &ProfilerOverlay::toggle);
     
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-            connect(board->cell[i][j], &Cell::clicked, this, &Game::clickCell);
+    connect(board, &Board::clicked, this, &Game::clickCell);
+    connect(board, &Board::animationFinished, this, &Game::animationFinished);
     
     QHBoxLayout *layout = new QHBoxLayout;
     layout->addWidget(board);
@@ -283,8 +406,9 @@ Game::Game(GameEngine &engine, QString name0, QString ip0, QString name1, QStrin
 
 void Game::start()
 {
-    qInfo("Game started: role = %d", gameEngine.role());
+    qCInfo(lcGame, "Game started: role = %d", gameEngine.role());
 
+    gameHistory.reset(gameEngine);
     gameEngine.switchWhoseTurn();
     focus = QPoint(-1, -1);
     focusLocked = false;
@@ -294,25 +418,20 @@ void Game::start()
 
 void Game::setFocus(int x, int y, bool mustJump)
 {
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-            board->cell[i][j]->setFocused(false);    
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-            board->cell[i][j]->setHighlighted(false);
+    board->clearMarks();
     if (x != -1)
     {
         auto next = gameEngine.nextCells(x, y, mustJump);
         int nextSize = next.size();
         for (int i = 0; i < nextSize; ++i)
-            board->cell[next[i].x()][next[i].y()]->setHighlighted(true);
+            board->setHighlighted(next[i].x(), next[i].y(), true);
         if (mustJump && !nextSize)
         {
             focus = QPoint(-1, -1);
             return;
         }
         else
-            board->cell[x][y]->setFocused(true);
+            board->setFocused(x, y, true);
                 
     }
     focus = QPoint(x, y);
@@ -336,7 +455,7 @@ void Game::clickCell(int x, int y)
     else
     {
         if (focus == QPoint(-1, -1)) return;
-        if (!board->cell[x][y]->isHighlighted())
+        if (!board->isHighlighted(x, y))
         {
             if (!focusLocked)
                 setFocus(-1, -1);
@@ -366,8 +485,14 @@ void Game::clickCell(int x, int y)
 
 bool Game::move(QPoint S, QPoint E, bool informOpponent)
 {
+    // the opponent's clock stops as soon as their move arrives
+    if (!gameEngine.isMyTurn())
+        stopClock();
+    if (currentMove.isNull())
+        moveStart = gameEngine;
+    MoveGenerator::addHop(gameEngine, currentMove, S, E);
     bool hasDied = gameEngine.move(S, E);
-    board->update();
+    board->refresh();
     
     lastMove = E;
     
@@ -384,10 +509,27 @@ bool Game::move(QPoint S, QPoint E, bool informOpponent)
     return hasDied;
 }
 
+bool Game::isLegalHop(QPoint S, QPoint E)
+{
+    if (gameEngine.isFinished())
+        return false;
+    if (currentMove.isNull())
+        return gameEngine.isLegalHop(S, E);
+    // only a capture goes on, and from where it stopped
+    return currentMove.captured && S == currentMove.to() && gameEngine.isLegalHop(S, E, true);
+}
+
 void Game::endMove(bool informOpponent)
 {
     bool hasAchievements = gameEngine.applyMoveAchievements(lastMove);
-    board->update();
+    board->refresh();
+    gameHistory.push(moveStart, currentMove);
+    Move played = currentMove;
+    currentMove = Move{};
+    int mover = gameEngine.isMyTurn() ? 1 : 0;
+    stopClock();
+    if (timeControl.isEnabled())
+        clock[mover] += timeControl.increment;
     if (hasAchievements)
     {
         if (informOpponent)
@@ -400,7 +542,11 @@ void Game::endMove(bool informOpponent)
     }
     switchCurrent();
     if (informOpponent)
-        emit sendMessage("endMove");
+    {
+        emit sendMessage("endMove " + played.pack());
+        if (timeControl.isEnabled())
+            emit sendMessage(QString("time %1").arg(clock[1]));
+    }
 }
 
 void Game::switchCurrent()
@@ -412,11 +558,20 @@ void Game::switchCurrent()
         bool active = gameEngine.whoseTurn() ^ i ^ gameEngine.role();
         gameSidebar->player[i]->status->setActive(active);
     }
+    // the side to move without a move has lost
     auto hasNext = gameEngine.updateMovable();
-    if (!hasNext)
+    if (!hasNext && gameEngine.isMyTurn())
         lose();
-
-    if (!gameEngine.isMyTurn())
+    else if (!hasNext)
+        win();
+    else if (auto rule = gameHistory.draw())
+        draw(GameHistory::describe(rule));
+    if (!gameEngine.isFinished())
+        startClock(gameEngine.isMyTurn() ? 1 : 0);
+    if (gameSidebar->analysis->isVisible())
+        gameSidebar->analysis->analyze(gameEngine);
+
+    if (!gameEngine.isFinished() && !gameEngine.isMyTurn())
         emit sendMessage("wait");
 }
 
@@ -424,12 +579,8 @@ void Game::lose(QString message)
 {
     if (gameEngine.isFinished()) return;
     gameEngine.setFinished();
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-        {
-            board->cell[i][j]->setFocused(false);
-            board->cell[i][j]->setHighlighted(false);
-        }    
+    stopClock();
+    board->clearMarks();
     emit sendMessage("finish");    
     for (int k = 0; k < 2; ++k)
         gameSidebar->player[k]->status->setActive(false);
@@ -442,12 +593,8 @@ void Game::win(QString message)
 {
     if (gameEngine.isFinished()) return;
     gameEngine.setFinished();
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-        {
-            board->cell[i][j]->setFocused(false);
-            board->cell[i][j]->setHighlighted(false);
-        }    
+    stopClock();
+    board->clearMarks();
     for (int k = 0; k < 2; ++k)
         gameSidebar->player[k]->status->setActive(false);
     gameSidebar->player[1]->status->setWinner();
@@ -455,21 +602,17 @@ void Game::win(QString message)
     QMessageBox::information(this, "You win", QString("<h2>You win!</h2><p>%1</p>").arg(message));
 }
 
-void Game::draw()
+void Game::draw(QString message)
 {
     for (int i = 0; i < 2; ++i)
     {
         gameSidebar->player[i]->status->setActive(false);
         gameSidebar->player[i]->status->setWinner();
     }
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-        {
-            board->cell[i][j]->setFocused(false);
-            board->cell[i][j]->setHighlighted(false);
-        }
+    board->clearMarks();
     gameEngine.setFinished();
-    QMessageBox::information(this, "Draw", "<h2>Draw.</h2>");    
+    stopClock();
+    QMessageBox::information(this, "Draw", QString("<h2>Draw.</h2><p>%1</p>").arg(message));
 }
 
 void Game::requestDraw()
@@ -516,6 +659,22 @@ void Game::switchSound(QString text)
     }
 }
 
+void Game::switchAnalysis(QString text)
+{
+    if (text == "Analysis: Off")
+    {
+        gameSidebar->buttons->buttonAnalysis->setText("Analysis: On");
+        gameSidebar->analysis->show();
+        gameSidebar->analysis->analyze(gameEngine);
+    }
+    else
+    {
+        gameSidebar->buttons->buttonAnalysis->setText("Analysis: Off");
+        gameSidebar->analysis->stop();
+        gameSidebar->analysis->hide();
+    }
+}
+
 void Game::playSound(QSoundEffect *sound)
 {
     if (this->sound)
@@ -529,6 +688,100 @@ QSoundEffect* Game::renderSound(QString url)
     return sound;
 }
 
+static QString formatClock(qint64 time)
+{
+    time = std::max<qint64>(time, 0);
+    if (time < 10000)
+        return QString("%1.%2").arg(time / 1000).arg(time / 100 % 10);
+    time = (time + 999) / 1000;
+    return QString("%1:%2").arg(time / 60).arg(time % 60, 2, 10, QChar('0'));
+}
+
+void Game::setClock(TimeControl timeControl, bool judgeOpponent)
+{
+    this->timeControl = timeControl;
+    judgeOpponentClock = judgeOpponent;
+    clock[0] = clock[1] = timeControl.base;
+    for (int i = 0; i < 2; ++i)
+        gameSidebar->player[i]->clock->setVisible(timeControl.isEnabled());
+    updateClocks();
+}
+
+bool Game::hasClock() const
+{
+    return timeControl.isEnabled();
+}
+
+qint64 Game::remainingTime(int player) const
+{
+    return clock[player] - (clockRunning == player ? clockTimer.elapsed() : 0);
+}
+
+qint64 Game::clockIncrement() const
+{
+    return timeControl.increment;
+}
+
+const GameHistory &Game::history() const
+{
+    return gameHistory;
+}
+
+const Move &Game::pendingMove() const
+{
+    return currentMove;
+}
+
+bool Game::isAnimating() const
+{
+    return board->isAnimating();
+}
+
+void Game::setRemainingTime(int player, qint64 time)
+{
+    clock[player] = time;
+    if (clockRunning == player)
+        clockTimer.start();
+    updateClocks();
+}
+
+void Game::startClock(int player)
+{
+    if (!timeControl.isEnabled())
+        return;
+    stopClock();
+    clockRunning = player;
+    clockTimer.start();
+    clockTicker->start(100);
+}
+
+void Game::stopClock()
+{
+    if (clockRunning != -1)
+        clock[clockRunning] -= clockTimer.elapsed();
+    clockRunning = -1;
+    clockTicker->stop();
+    updateClocks();
+}
+
+void Game::updateClocks()
+{
+    if (!timeControl.isEnabled())
+        return;
+    for (int i = 0; i < 2; ++i)
+        gameSidebar->player[i]->clock->setText(formatClock(remainingTime(i)));
+
+    if (clockRunning == -1 || remainingTime(clockRunning) > 0)
+        return;
+    int flagged = clockRunning;
+    stopClock();
+    if (flagged == 1)
+        lose("Your time is up.");
+    // an online opponent's own client tells us, its clock is the authoritative one
+    else if (judgeOpponentClock)
+        win("Your opponent ran out of time.");
+}
+
 void Game::closeEvent(QCloseEvent *event)
 {
     if (resign())
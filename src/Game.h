@@ -22,45 +22,55 @@
 #define GAME_H
 
 #include "Common.h"
-
-class GameEngine;
-
-class Cell : public QLabel
+#include "TimeManager.h"
+#include "GameEngine.h"
+#include "GameHistory.h"
+#include "MoveGenerator.h"
+
+class AnalysisPanel;
+class BoardAnimator;
+
+// The whole board in one widget, painted square by square from the engine's
+// board and the focus and highlight marks. Changes only invalidate the squares
+// they touch (GameEngine::changes() for moves), so a move repaints a handful of
+// squares instead of the board.
+class Board : public Widget
 {
     Q_OBJECT
 
 public:
-    explicit Cell(GameEngine &engine, QColor background, int x, int y, QWidget *parent = nullptr);
-    void setOccupier(int occupier, bool king = false);
-    void setFocused(bool focused);
-    void setHighlighted(bool highlighted);
-    bool isHighlighted() const;
-    
+    explicit Board(GameEngine &engine, QWidget *parent = nullptr);
+    void setOccupier(int x, int y, int occupier, bool king = false);
+    void setFocused(int x, int y, bool focused);
+    void setHighlighted(int x, int y, bool highlighted);
+    bool isHighlighted(int x, int y) const;
+    void clearMarks();
+    // repaints the squares the engine reports as changed, and clears them;
+    // hops slide and captured pieces fade out
+    void refresh();
+    bool isAnimating() const;
+
 signals:
-    void clicked(int x, int y);    
-    
-private:
-    void paintEvent(QPaintEvent *);
-    void mousePressEvent(QMouseEvent *event);
+    void clicked(int x, int y);
+    void animationFinished();
 
-    GameEngine &gameEngine;
-    QColor background;
-    int x, y;
-    bool focused, highlighted;
-};
+protected:
+    void paintEvent(QPaintEvent *event);
+    void mousePressEvent(QMouseEvent *event);
 
-class Board : public Widget
-{
-    Q_OBJECT
+private slots:
+    void animationFrame(const QVector<QRectF> &area);
 
-public:
-    explicit Board(GameEngine &engine, QWidget *parent = nullptr);
-    
 private:
-    Cell *cell[10][10];
-    
-    friend class Game;
-    friend class Generator;
+    QPoint viewed(QPoint square) const;
+    QRect cellRect(int x, int y) const;
+    QRectF squaresRect(const QRectF &squares) const;
+    QPoint cellAt(QPoint pos) const;
+
+    GameEngine &gameEngine;
+    bool focused[GameEngine::Size][GameEngine::Size], highlighted[GameEngine::Size][GameEngine::Size];
+    BoardAnimator *animator;
+    QHash<int, GameEngine::Cell> captured; // taken pieces waiting to be removed, by square
 };
 
 class GameSidebarPlayerStatus : public QLabel
@@ -77,7 +87,8 @@ private:
     
     QPen pen;
     QBrush brush;
-    QPixmap winner;
+    int role;
+    bool winner;
     
     friend class Game;
 };
@@ -93,7 +104,7 @@ private:
     QLabel* renderText(QString text);
     
     GameSidebarPlayerStatus *status;    
-    QLabel *name, *ip;
+    QLabel *name, *ip, *clock;
     
     friend class Game;
 };
@@ -108,7 +119,7 @@ public:
 private:
     Button* renderButton(QString text);
     
-    Button *buttonRequestDraw, *buttonResign, *buttonSound;    
+    Button *buttonRequestDraw, *buttonResign, *buttonSound, *buttonAnalysis;
     
     friend class Game;
 };
@@ -123,6 +134,7 @@ public:
 private:
     GameSidebarPlayer *player[2];  
     GameSidebarButtons *buttons;
+    AnalysisPanel *analysis;
     
     friend class Game;
 };
@@ -136,19 +148,38 @@ public:
     void start();
     void lose(QString message = "");
     void win(QString message = "Congratulations!");  
-    void draw();
+    void draw(QString message = "");
     void endMove(bool informOpponent = true);
     bool move(QPoint S, QPoint E, bool informOpponent = false);
+    // whether move() may play the hop now, going on with the capture in progress
+    bool isLegalHop(QPoint S, QPoint E);
+
+    // clocks are indexed like the sidebar players: 0 the opponent, 1 me
+    void setClock(TimeControl timeControl, bool judgeOpponent = false);
+    bool hasClock() const;
+    qint64 remainingTime(int player) const;
+    qint64 clockIncrement() const;
+    void setRemainingTime(int player, qint64 time);
+
+    // positions since the start, for the draw rules
+    const GameHistory &history() const;
+    // the hops played since the last endMove() as one move
+    const Move &pendingMove() const;
+    // whether the board is still showing the last hops
+    bool isAnimating() const;
     
 private slots:
     void clickCell(int x, int y); 
     void requestDraw();
     bool resign();
     void switchSound(QString text);
+    void switchAnalysis(QString text);
+    void updateClocks();
     
 signals:
     void sendMessage(QString message); 
     void checkMessages();
+    void animationFinished();
     
 private:
     void closeEvent(QCloseEvent *event);
@@ -156,16 +187,30 @@ private:
     void switchCurrent();
     void playSound(QSoundEffect *sound);
     QSoundEffect* renderSound(QString url);
+    void startClock(int player);
+    void stopClock();
     
     GameEngine &gameEngine;
 
     Board *board;
     GameSidebar *gameSidebar;
     QPoint focus, lastMove;
+    GameEngine moveStart; // before the first hop of the move being played
+    Move currentMove;
+    GameHistory gameHistory;
     bool focusLocked;
     
     QSoundEffect *soundMove, *soundEat, *soundWin, *soundLose;
     bool sound;
+
+    TimeControl timeControl;
+    bool judgeOpponentClock = false;
+    qint64 clock[2] = {0, 0};
+    int clockRunning = -1;
+    QElapsedTimer clockTimer;
+    QTimer *clockTicker;
+
+    ProfilerOverlay *profilerOverlay;
 };
 
 #endif
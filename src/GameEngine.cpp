@@ -1,5 +1,8 @@
 #include "GameEngine.h"
+#include "Geometry.h"
+#include "Profiler.h"
 #include <QTextStream>
+#include <algorithm>
 
 GameEngine::Cell::Cell(int occupier, bool king_)
     : cellOccupier(occupier), king(king_)
@@ -63,38 +66,72 @@ GameEngine::GameEngine(QString state)
     readState(std::move(state));
 }
 
-void GameEngine::readState(QString state)
+// Anything that isn't a position the rules can reach in some game is
+// refused, as the text may come from a file or from the network.
+bool GameEngine::readState(QString state)
 {
-    if (!state.isEmpty())
-    {
-        QTextStream in(&state);
-        in >> me >> current;
-        for (int i = 0; i < 10; ++i)
-            for (int j = 0; j < 10; ++j)
+    QTextStream in(&state);
+    int role = -1, turn = -2;
+    in >> role >> turn;
+    if (in.status() != QTextStream::Ok || role < 0 || role > 1 || turn < -1 || turn > 1)
+        return false;
+
+    Board<Cell> read;
+    int pieces[2] = {0, 0};
+    for (int i = 0; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
+        {
+            int occupier = -2, king = -1;
+            in >> occupier >> king;
+            if (in.status() != QTextStream::Ok || occupier < -1 || occupier > 1 || king < 0 || king > 1)
+                return false;
+            int square = viewed(role, i * Size + j);
+            if (occupier == -1)
             {
-                int occupier = -1, king = -1;
-                in >> occupier >> king;
-                board.get(i, j).setOccupier(occupier, king);
+                if (king)
+                    return false;
+                continue;
             }
-    }
+            // pieces stand on the dark squares and men don't stay on the far row
+            int x = square / Size, y = square % Size;
+            if (!((x + y) & 1) || (!king && x == (occupier == 0 ? 0 : Size - 1)))
+                return false;
+            if (++pieces[occupier] > Rules::Rows * Size / 2)
+                return false;
+            read.get(square).setOccupier(occupier, king);
+        }
+
+    me = role;
+    current = turn;
+    board = read;
+    changed = Changes{};
+    changed.squares.set();
+    return true;
+}
+
+bool GameEngine::isInside(QPoint p)
+{
+    return p.x() >= 0 && p.x() < Size && p.y() >= 0 && p.y() < Size;
 }
 
 void GameEngine::reset(int role, int whoseTurn)
 {
     setRole(role);
     setWhoseTurn(whoseTurn);
+    changed = Changes{};
+    changed.squares.set();
 
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
+    for (int i = 0; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
             board.get(i, j).setOccupier(-1);
-    for (int i = 0; i < 4; ++i)
-        for (int j = 0; j < 10; ++j)
+    for (int i = 0; i < Rules::Rows; ++i)
+        for (int j = 0; j < Size; ++j)
             if ((i + j) & 1)
-                board.get(i, j).setOccupier(1 - role, false);
-    for (int i = 6; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
+                board.get(i, j).setOccupier(1, false);
+    for (int i = Size - Rules::Rows; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
             if ((i + j) & 1)
-                board.get(i, j).setOccupier(role, false);
+                board.get(i, j).setOccupier(0, false);
 }
 
 int GameEngine::role() const
@@ -104,16 +141,9 @@ int GameEngine::role() const
 
 void GameEngine::setRole(int role)
 {
-    if (me != role)
-        transpose();
     me = role;
 }
 
-void GameEngine::changeRole()
-{
-    setRole(1 - role());
-}
-
 int GameEngine::whoseTurn() const
 {
     return current;
@@ -145,52 +175,42 @@ bool GameEngine::isMyTurn() const
     return whoseTurn() == role();
 }
 
-constexpr int dx[4] = {-1, -1, 1, 1};
-constexpr int dy[4] = {1, -1, 1, -1};
-
-static bool isOutOfBoard(int x, int y)
-{
-    return x < 0 || y < 0 || x >= 10 || y >= 10;
-}
-
-void GameEngine::dfs(int x, int y, int len, int maxStep)
+void GameEngine::dfs(int square, int occupier, int len, int maxStep)
 {
     if (len > longestEating)
     {
         longestEating = len;
         nextTemp->reset();
-        nextTemp.get(path[0].x(), path[0].y()) = true;
+        nextTemp.get(path[0]) = true;
     }
     else if (len == longestEating && path.size())
-        nextTemp.get(path[0].x(), path[0].y()) = true;
+        nextTemp.get(path[0]) = true;
 
-    for (int k = 0; k < 4; ++k)
-        for (int step = 1; step <= maxStep; ++step)
+    for (auto &ray : Geometry::tables<Size>.rays[square])
+    {
+        int reach = std::min(ray.length, maxStep);
+        for (int step = 0; step < reach; ++step)
         {
-            int xx = x + dx[k] * step;
-            int yy = y + dy[k] * step;
-
-            if (isOutOfBoard(xx, yy)) break;
-            if (!board.get(xx, yy).isEmpty())
+            int victim = ray.squares[step];
+            auto &cell = board.get(victim);
+            if (cell.isEmpty())
+                continue;
+            if (cell.occupier() == occupier || vis.get(victim) || cell.isDied()) break;
+
+            int end = std::min(ray.length, step + 1 + maxStep);
+            for (int next = step + 1; next < end; ++next)
             {
-                if (isMine(xx, yy)) break;
-                if (vis.get(xx, yy) || board.get(xx, yy).isDied()) break;
-
-                for (int nextStep = 1; nextStep <= maxStep; ++nextStep)
-                {
-                    int xxx = xx + dx[k] * nextStep;
-                    int yyy = yy + dy[k] * nextStep;
-                    if (isOutOfBoard(xxx, yyy)) break;
-                    if (!board.get(xxx, yyy).isEmpty()) break;
-                    if (vis.get(xxx, yyy)) break;
-                    vis.get(xx, yy) = true;
-                    path.push_back(QPoint(xxx, yyy));
-                    dfs(xxx, yyy, len + 1, maxStep);
-                    path.pop_back();
-                    vis.get(xx, yy) = false;
-                }
-                break;
+                int landing = ray.squares[next];
+                if (!board.get(landing).isEmpty()) break;
+                if (vis.get(landing)) break;
+                vis.get(victim) = true;
+                path.push_back(landing);
+                dfs(landing, occupier, len + 1, maxStep);
+                path.pop_back();
+                vis.get(victim) = false;
             }
+            break;
+        }
     }
 }
 
@@ -201,31 +221,32 @@ int GameEngine::lengthEating(int x, int y)
     vis->reset();
     auto &cell = board.get(x, y);
     bool isKing = cell.isKing();
-    int maxStep = isKing ? 9 : 1;
+    int maxStep = isKing && Rules::FlyingKings ? Size - 1 : 1;
     int occupier = cell.occupier();
     cell.setOccupier(-1);
-    dfs(x, y, 0, maxStep);
+    dfs(x * Size + y, occupier, 0, maxStep);
     cell.setOccupier(occupier, isKing);
     return longestEating;
 }
 
 bool GameEngine::updateMovable()
 {
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
+    PROFILE_SCOPE("engine.updateMovable");
+    for (int i = 0; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
             board.get(i, j).setMovable(false);
-    int length[10][10], maxLength = 0;
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-            if (isMine(i, j))
+    int length[Size][Size], maxLength = 0;
+    for (int i = 0; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
+            if (board.get(i, j).occupier() == current)
             {
                 length[i][j] = lengthEating(i, j);
                 maxLength = std::max(maxLength, length[i][j]);
             }
     bool hasNext = false;
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-            if (isMine(i, j) && length[i][j] == maxLength)
+    for (int i = 0; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
+            if (board.get(i, j).occupier() == current && length[i][j] == maxLength)
             {
                 board.get(i, j).setMovable(true);
                 hasNext = true;
@@ -233,41 +254,53 @@ bool GameEngine::updateMovable()
     return hasNext;
 }
 
-vector<QPoint> GameEngine::nextCells(int x, int y, bool mustJump)
+GameEngine::Cells GameEngine::nextCells(int x, int y, bool mustJump)
 {
-    vector<QPoint> res;
+    PROFILE_SCOPE("engine.nextCells");
+    Cells res;
 
     lengthEating(x, y);
 
     if (longestEating)
     {
-        for (int i = 0; i < 10; ++i)
-            for (int j = 0; j < 10; ++j)
+        for (int i = 0; i < Size; ++i)
+            for (int j = 0; j < Size; ++j)
                 if (nextTemp.get(i, j))
                     res.push_back(QPoint(i, j));
     }
 
     if (!mustJump && !res.size())
     {
-        int maxStep = board.get(x, y).isKing() ? 9 : 1;
-        for (int k = 0; k < (board.get(x, y).isKing() ? 4 : 2); ++k)
-            for (int step = 1; step <= maxStep; ++step)
+        // men only move forward: the first two directions for black, which
+        // starts on the high rows, the last two for white
+        auto &cell = board.get(x, y);
+        bool isKing = cell.isKing();
+        int maxStep = isKing && Rules::FlyingKings ? Size - 1 : 1;
+        auto &rays = Geometry::tables<Size>.rays[x * Size + y];
+        int first = isKing || cell.occupier() == 0 ? 0 : 2;
+        int last = isKing || cell.occupier() == 1 ? 4 : 2;
+        for (int k = first; k < last; ++k)
+        {
+            int reach = std::min(rays[k].length, maxStep);
+            for (int step = 0; step < reach; ++step)
             {
-                int xx = x + dx[k] * step;
-                int yy = y + dy[k] * step;
-                if (isOutOfBoard(xx, yy)) break;
-                if (!board.get(xx, yy).isEmpty()) break;
-                res.push_back(QPoint(xx, yy));
+                int square = rays[k].squares[step];
+                if (!board.get(square).isEmpty()) break;
+                res.push_back(QPoint(square / Size, square % Size));
             }
+        }
     }
     return res;
 }
 
-void GameEngine::transpose()
+const GameEngine::Changes &GameEngine::changes() const
 {
-    for (int i = 0; i < 10 / 2; ++i)
-        for (int j = 0; j < 10; ++j)
-            std::swap(board.get(i, j), board.get(9 - i, 9 - j));
+    return changed;
+}
+
+void GameEngine::clearChanges()
+{
+    changed = Changes{};
 }
 
 bool GameEngine::isMine(int x, int y) const
@@ -275,43 +308,54 @@ bool GameEngine::isMine(int x, int y) const
     return board.get(x, y).occupier() == role();
 }
 
+// the board is kept as black sees it, role 1 sees it mirrored
+int GameEngine::viewed(int role, int square)
+{
+    return role == 1 ? Size * Size - 1 - square : square;
+}
+
 QString GameEngine::state(bool opponent) const
 {
-    if (!opponent)
+    int viewer = opponent ? 1 - me : me;
+    QString res;
+    QTextStream out(&res);
+    out << viewer << " " << current << "\n";
+    for (int i = 0; i < Size; ++i)
     {
-        QString res;
-        QTextStream out(&res);
-        out << me << " " << current << "\n";
-        for (int i = 0; i < 10; ++i)
+        for (int j = 0; j < Size; ++j)
         {
-            for (int j = 0; j < 10; ++j)
-                out << (board.get(i, j).occupier()) << " " << (board.get(i, j).isKing()) << " ";
-            out << "\n";
+            auto &cell = board.get(viewed(viewer, i * Size + j));
+            out << cell.occupier() << " " << cell.isKing() << " ";
         }
-        return res;
-    }
-    else
-    {
-        auto opponentEngine = *this;
-        opponentEngine.setRole(1 - me);
-        return opponentEngine.state(false);
+        out << "\n";
     }
+    return res;
+}
 
-    return {};
+bool GameEngine::isLegalHop(QPoint S, QPoint E, bool mustJump)
+{
+    if (!isInside(S) || !isInside(E) || board.get(S.x(), S.y()).occupier() != current)
+        return false;
+    if (!mustJump && !board.get(S.x(), S.y()).isMovable())
+        return false;
+    auto next = nextCells(S.x(), S.y(), mustJump);
+    return std::find(next.begin(), next.end(), E) != next.end();
 }
 
 bool GameEngine::move(QPoint S, QPoint E)
 {
+    PROFILE_SCOPE("engine.move");
+    assert(isInside(S) && isInside(E));
     auto hasDied = false;
-    int dx = (S.x() < E.x()) ? 1 : -1;
-    int dy = (S.y() < E.y()) ? 1 : -1;
-    for (int x = S.x() + dx, y = S.y() + dy; x != E.x() && y != E.y(); x += dx, y += dy)
+    for (int square : Geometry::tables<Size>.between(S.x() * Size + S.y(), E.x() * Size + E.y()))
     {
-        auto &cell = board.get(x, y);
+        auto &cell = board.get(square);
         if (!cell.isEmpty())
         {
             cell.setDied(true);
             hasDied = true;
+            changed.squares.set(square);
+            changed.captured.set(square);
         }
     }
 
@@ -320,6 +364,10 @@ bool GameEngine::move(QPoint S, QPoint E)
 
     endCell.setOccupier(startCell.occupier(), startCell.isKing());
     startCell.setOccupier(-1);
+    changed.squares.set(Changes::index(S.x(), S.y()));
+    changed.squares.set(Changes::index(E.x(), E.y()));
+    changed.from = S;
+    changed.to = E;
 
     return hasDied;
 }
@@ -327,8 +375,8 @@ bool GameEngine::move(QPoint S, QPoint E)
 bool GameEngine::clearCorpses()
 {
     bool hasDied = false;
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
+    for (int i = 0; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
         {
             auto &cell = board.get(i, j);
             if (cell.isDied())
@@ -336,6 +384,7 @@ bool GameEngine::clearCorpses()
                 cell.setOccupier(-1);
                 cell.setDied(false);
                 hasDied = true;
+                changed.squares.set(Changes::index(i, j));
             }
         }
     return hasDied;
@@ -347,11 +396,13 @@ bool GameEngine::promote(int x, int y)
     if (cell.isKing())
         return false;
 
-    int isMineKing = isMine(x, y);
-    if ((x == 0 && isMineKing) ||
-        (x == 9 && !isMineKing))
+    // the far row of each side
+    if ((x == 0 && cell.occupier() == 0) ||
+        (x == Size - 1 && cell.occupier() == 1))
     {
         cell.setOccupier(cell.occupier(), true);
+        changed.squares.set(Changes::index(x, y));
+        changed.promoted.set(Changes::index(x, y));
         return true;
     }
 
@@ -360,6 +411,7 @@ bool GameEngine::promote(int x, int y)
 
 bool GameEngine::applyMoveAchievements(QPoint lastMove)
 {
+    PROFILE_SCOPE("engine.applyMoveAchievements");
     bool t1 = promote(lastMove.x(), lastMove.y());
     bool t2 = clearCorpses();
     return t1 || t2;
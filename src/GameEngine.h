@@ -4,24 +4,47 @@
 #include <bitset>
 #include <QString>
 #include <QPoint>
+#include "Variants.h"
 #include "Vector.h"
 
+// The board has a single orientation: black (occupier 0) starts on the high
+// rows and moves towards row 0, white the other way. Only the views mirror it
+// for the player with role 1. Moves are those of whoseTurn().
 class GameEngine
 {
 public:
+    // the rules the engine plays, other variants have their own generators
+    // in VariantPosition.h
+    using Rules = Variants::International;
+    static constexpr int Size = Rules::Size;
+    // bounds for the fixed size lists below: a capture takes at most the
+    // pieces of one side, a piece reaches at most both of its diagonals
+    static constexpr int MaxCaptures = Rules::Rows * Size / 2;
+    using Cells = FixedVector<QPoint, 2 * (Size - 1)>;
+
     template<typename T, typename Dummy = void> // workaround for https://gcc.gnu.org/bugzilla/show_bug.cgi?id=85282
     class Board
     {
-        std::array<T, 10 * 10> container;
+        std::array<T, Size * Size> container;
     public:
         const T &get(int i, int j) const
         {
-            return container[i * 10 + j];
+            return container[i * Size + j];
         }
 
         T &get(int i, int j)
         {
-            return container[i * 10 + j];
+            return container[i * Size + j];
+        }
+
+        const T &get(int square) const
+        {
+            return container[square];
+        }
+
+        T &get(int square)
+        {
+            return container[square];
         }
 
         auto *operator->()
@@ -33,11 +56,16 @@ public:
     template<typename Dummy>
     class Board<bool, Dummy>
     {
-        std::bitset<10 * 10> container;
+        std::bitset<Size * Size> container;
     public:
         auto get(int i, int j)
         {
-            return container[i * 10 + j];
+            return container[i * Size + j];
+        }
+
+        auto get(int square)
+        {
+            return container[square];
         }
 
         auto *operator->()
@@ -69,14 +97,26 @@ public:
     };
     Board<Cell> board;
 
+    // Squares touched since the last clearChanges(), bit x * Size + y, so a view
+    // can redraw (or animate) exactly what a move did instead of the board.
+    struct Changes
+    {
+        std::bitset<Size * Size> squares;  // everything that looks different now
+        std::bitset<Size * Size> captured; // pieces taken, marked by move() and removed by applyMoveAchievements()
+        std::bitset<Size * Size> promoted;
+        QPoint from = QPoint(-1, -1), to = QPoint(-1, -1); // the last hop
+
+        static int index(int x, int y) { return x * Size + y; }
+    };
+
     explicit GameEngine(int role = 0, int whoseTurn = 0);
-    explicit GameEngine(QString state);
+    explicit GameEngine(QString state); // role() is -1 if the state is invalid
 
     void reset(int role = 0, int whoseTurn = 0);
 
+    // the local player, the board itself doesn't depend on it
     int role() const;
     void setRole(int role);
-    void changeRole();
     bool isMine(int x, int y) const;
     int whoseTurn() const;
     void setWhoseTurn(int whoseTurn);
@@ -84,24 +124,38 @@ public:
     bool isMyTurn() const;
     void setFinished();
     bool isFinished() const;
-    bool updateMovable(); // returns true if has next move
-    vector<QPoint> nextCells(int x, int y, bool mustJump = false);
+    bool updateMovable(); // for whoseTurn(), returns true if has next move
+    Cells nextCells(int x, int y, bool mustJump = false);
+    // whether whoseTurn() may play the hop now: from a movable piece, or with
+    // mustJump as the next capture of a piece already capturing
+    bool isLegalHop(QPoint S, QPoint E, bool mustJump = false);
+    // trusts the hop to be legal, see isLegalHop()
     bool move(QPoint S, QPoint E); // returns true if has died
     bool applyMoveAchievements(QPoint lastMove); // returns true if has some achievement
 
+    const Changes &changes() const;
+    void clearChanges();
+
+    // the board as role() (or the opponent) sees it, so role 1 reads it mirrored
     QString state(bool opponent = false) const;
-    void readState(QString state);
-    void transpose();
+    // leaves the engine as it was and returns false unless state is a valid
+    // position: pieces on the dark squares, no man on its last row, at most
+    // as many pieces as a side starts with
+    bool readState(QString state);
 
 private:
     int me = -1, current = -1;
 
+    Changes changed;
+
     int longestEating = 0;
     Board<bool> nextTemp, vis;
-    vector<QPoint> path;
+    FixedVector<int, MaxCaptures> path; // squares, see Geometry.h
 
+    static int viewed(int role, int square);
+    static bool isInside(QPoint p);
     int lengthEating(int x, int y);
-    void dfs(int x, int y, int len, int maxStep);
+    void dfs(int square, int occupier, int len, int maxStep);
     bool clearCorpses();
     bool promote(int x, int y);
 };
@@ -0,0 +1,155 @@
+#include "GameHistory.h"
+#include "GameEngine.h"
+#include "Random.h"
+#include "MoveGenerator.h"
+
+namespace
+{
+
+// square * 4 + occupier * 2 + king, then one key for white to move
+using Keys = std::array<uint64_t, GameEngine::Size * GameEngine::Size * 4 + 1>;
+
+Keys makeKeys()
+{
+    Keys keys;
+    uint64_t seed = 0x2545f4914f6cdd1dull;
+    for (auto &key : keys)
+    {
+        key = splitmix64(seed);
+    }
+    return keys;
+}
+
+const Keys keys = makeKeys();
+
+uint64_t pieceKey(int square, int occupier, bool king)
+{
+    return keys[square * 4 + occupier * 2 + king];
+}
+
+}
+
+int GameHistory::square(int x, int y)
+{
+    return x * GameEngine::Size + y;
+}
+
+void GameHistory::reset(const GameEngine &engine)
+{
+    Ply ply{engine.whoseTurn() == 1 ? keys.back() : 0, 0, 0, {0, 0}, {0, 0}};
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+        {
+            auto &cell = engine.board.get(i, j);
+            if (cell.isEmpty() || cell.isDied())
+                continue;
+            ply.key ^= pieceKey(square(i, j), cell.occupier(), cell.isKing());
+            ++(cell.isKing() ? ply.kings : ply.men)[cell.occupier()];
+        }
+    plies.assign(1, ply);
+}
+
+void GameHistory::push(const GameEngine &before, const Move &move)
+{
+    Ply ply = plies.back();
+    auto &piece = before.board.get(move.start);
+    int occupier = piece.occupier();
+    bool king = piece.isKing();
+    int captured = 0;
+
+    for (int square : move.capturedSquares())
+    {
+        auto &cell = before.board.get(square);
+        ply.key ^= pieceKey(square, cell.occupier(), cell.isKing());
+        --(cell.isKing() ? ply.kings : ply.men)[cell.occupier()];
+        ++captured;
+    }
+
+    ply.key ^= pieceKey(move.start, occupier, king);
+    ply.key ^= pieceKey(move.end, occupier, king || move.promotion);
+    ply.key ^= keys.back();
+    if (move.promotion)
+    {
+        --ply.men[occupier];
+        ++ply.kings[occupier];
+    }
+
+    ply.kingMoves = king && !captured ? ply.kingMoves + 1 : 0;
+    ply.endgameMoves = captured || move.promotion ? 0 : ply.endgameMoves + 1;
+
+    plies.push_back(ply);
+}
+
+void GameHistory::pop()
+{
+    plies.pop_back();
+}
+
+void GameHistory::reserve(int count)
+{
+    plies.reserve(plies.size() + count);
+}
+
+bool GameHistory::isEmpty() const
+{
+    return plies.empty();
+}
+
+uint64_t GameHistory::key() const
+{
+    return plies.back().key;
+}
+
+// A position can only come back while nothing but kings moved quietly and
+// with the same side to move, so only every other ply of that stretch counts.
+int GameHistory::repetitions() const
+{
+    int last = int(plies.size()) - 1;
+    uint64_t key = plies[last].key;
+    int res = 1;
+    for (int i = last - 2; i >= last - plies[last].kingMoves; i -= 2)
+        res += plies[i].key == key;
+    return res;
+}
+
+int GameHistory::endgameLimit(const Ply &ply) const
+{
+    for (int side = 0; side < 2; ++side)
+    {
+        int other = 1 - side;
+        if (ply.men[side] || ply.kings[side] != 1 || !ply.kings[other])
+            continue;
+        int pieces = ply.men[other] + ply.kings[other];
+        if (pieces == 3)
+            return ENDGAME_LIMIT;
+        if (pieces <= 2)
+            return SHORT_ENDGAME_LIMIT;
+    }
+    return 0;
+}
+
+GameHistory::Draw GameHistory::draw() const
+{
+    if (plies.empty())
+        return None;
+    auto &ply = plies.back();
+    if (repetitions() >= 3)
+        return Repetition;
+    if (ply.kingMoves >= KING_MOVES_LIMIT)
+        return KingMoves;
+    int limit = endgameLimit(ply);
+    if (limit && ply.endgameMoves >= limit)
+        return Endgame;
+    return None;
+}
+
+QString GameHistory::describe(Draw draw)
+{
+    switch (draw)
+    {
+    case Repetition: return "The same position occurred three times.";
+    case KingMoves: return "Only kings moved for 25 moves without capturing.";
+    case Endgame: return "The endgame was not won within the move limit.";
+    default: return "";
+    }
+}
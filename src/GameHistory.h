@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <QString>
+
+class GameEngine;
+struct Move;
+
+// Positions of a game so far, for the draw rules of international draughts:
+//  - the same position with the same side to move for the third time;
+//  - 25 moves each of only kings moving, without capturing;
+//  - once one side is down to a lone king against three pieces with at least
+//    one king, 16 more moves each, or 5 against two pieces or one.
+//
+// Each position is identified by a Zobrist key over the squares. Keys, counters
+// and material are updated from the move alone, which makes push and pop O(1)
+// and allocation free once reserved; the game loop and the search share this
+// code.
+class GameHistory
+{
+public:
+    enum Draw { None, Repetition, KingMoves, Endgame };
+
+    static constexpr int KING_MOVES_LIMIT = 25 * 2; // plies
+    static constexpr int ENDGAME_LIMIT = 16 * 2;
+    static constexpr int SHORT_ENDGAME_LIMIT = 5 * 2;
+
+    void reset(const GameEngine &engine);
+    // before is the position the move is played from, by whichever side
+    void push(const GameEngine &before, const Move &move);
+    void pop();
+    // room for as many more plies, so that the search never allocates
+    void reserve(int count);
+    bool isEmpty() const;
+
+    uint64_t key() const;
+    // times the current position has occurred, this one included
+    int repetitions() const;
+    Draw draw() const;
+    static QString describe(Draw draw);
+
+private:
+    struct Ply
+    {
+        uint64_t key;
+        int kingMoves;   // consecutive plies of quiet king moves
+        int endgameMoves; // plies since the material last changed
+        std::array<int, 2> men, kings;
+    };
+
+    static int square(int x, int y);
+    int endgameLimit(const Ply &ply) const;
+
+    std::vector<Ply> plies;
+};
@@ -19,6 +19,7 @@
 **********************************************************************/ 
 
 #include "Generator.h"
+#include "Analysis.h"
 
 Button* GeneratorSidebarButtons::renderButton(QString text)
 {
@@ -42,6 +43,7 @@ GeneratorSidebarButtons::GeneratorSidebarButtons(QWidget *parent) :
     buttonClear = renderButton("Clear");
     buttonImport = renderButton("Import");
     buttonExport = renderButton("Export");
+    buttonAnalyze = renderButton("Analyze");
     buttonDone = renderButton("Done");
     buttonStylePrimary = buttonFirst->styleSheet();
     buttonStyleHighlighted = buttonFirst->styleSheet() + QString("background: %1;").arg(Config::Colors::DANGEROUS);
@@ -58,6 +60,7 @@ GeneratorSidebarButtons::GeneratorSidebarButtons(QWidget *parent) :
     layout->addWidget(buttonClear);
     layout->addWidget(buttonImport);
     layout->addWidget(buttonExport);
+    layout->addWidget(buttonAnalyze);
     layout->addWidget(buttonDone);
     layout->addStretch();
     layout->setContentsMargins(20, 4, 20, 4);
@@ -109,11 +112,10 @@ Generator::Generator(QWidget *parent) :
     connect(sidebar->buttons->buttonClear, &Button::clicked, this, &Generator::clicked);
     connect(sidebar->buttons->buttonImport, &Button::clicked, this, &Generator::clicked);
     connect(sidebar->buttons->buttonExport, &Button::clicked, this, &Generator::clicked);
+    connect(sidebar->buttons->buttonAnalyze, &Button::clicked, this, &Generator::clicked);
     connect(sidebar->buttons->buttonDone, &Button::clicked, this, &Generator::clicked);
     
-    for (int i = 0; i < 10; ++i)
-        for (int j = 0; j < 10; ++j)
-            connect(board->cell[i][j], &Cell::clicked, this, &Generator::clickCell);
+    connect(board, &Board::clicked, this, &Generator::clickCell);
     
     QHBoxLayout *layout = new QHBoxLayout;
     layout->addWidget(board);
@@ -136,7 +138,7 @@ Generator::Generator(QWidget *parent) :
 void Generator::reset(int role)
 {
     gameEngine.reset(role);
-    board->update();
+    board->refresh();
 }
 
 void Generator::importData()
@@ -150,7 +152,11 @@ void Generator::importData()
         return;
     }
 
-    gameEngine.readState(f.readAll());
+    if (!gameEngine.readState(f.readAll()))
+    {
+        QMessageBox::information(this, "Can't read file", "Not a valid position!");
+        return;
+    }
     if (gameEngine.role() == 0)
         sidebar->buttons->buttonMe->setText("Me: Black");
     else
@@ -159,7 +165,7 @@ void Generator::importData()
         sidebar->buttons->buttonFirst->setText("First: Black");
     else
         sidebar->buttons->buttonFirst->setText("First: White");
-    board->update();
+    board->refresh();
 
     f.close();
     QMessageBox::information(this, "Imported", "Imported!");
@@ -197,22 +203,30 @@ void Generator::clicked(QString text)
     {
         gameEngine.setRole(0);
         sidebar->buttons->buttonMe->setText("Me: Black");
+        board->update(); // the board turns round
     }
     else if (text == "Me: Black")
     {
         gameEngine.setRole(1);
         sidebar->buttons->buttonMe->setText("Me: White");
+        board->update();
     }
     else if (text == "Clear")
     {
-        for (int i = 0; i < 10; ++i)
-            for (int j = 0; j < 10; ++j)
-                board->cell[i][j]->setOccupier(-1);
+        for (int i = 0; i < GameEngine::Size; ++i)
+            for (int j = 0; j < GameEngine::Size; ++j)
+                board->setOccupier(i, j, -1);
     }
     else if (text == "Import")
         importData();
     else if (text == "Export")
         exportData();
+    else if (text == "Analyze")
+    {
+        AnalysisDialog *dialog = new AnalysisDialog(gameEngine, this);
+        dialog->setAttribute(Qt::WA_DeleteOnClose);
+        dialog->show();
+    }
     else if (text == "Done")
         accept();
     else
@@ -226,7 +240,7 @@ void Generator::clicked(QString text)
             else
                 button[i]->setStyleSheet(sidebar->buttons->buttonStylePrimary);
     }
-    board->update();
+    board->refresh();
 }
 
 void Generator::clickCell(int x, int y)
@@ -234,13 +248,13 @@ void Generator::clickCell(int x, int y)
     if ((x + y) % 2 == 0) return;
     if (currentBtn == 4)
     {
-        board->cell[x][y]->setOccupier(-1);
+        board->setOccupier(x, y, -1);
     }
     else
     {
         int color = currentBtn < 2 ? 0 : 1;
         bool king = currentBtn % 2;
-        board->cell[x][y]->setOccupier(color, king);
+        board->setOccupier(x, y, color, king);
     }
 }
 
@@ -36,7 +36,7 @@ private:
     Button* renderButton(QString text);
     
     Button *buttonMe, *buttonFirst, *buttonWhiteMan, *buttonWhiteKing, *buttonBlackMan, *buttonBlackKing,
-           *buttonEraser, *buttonImport, *buttonExport, *buttonErase, *buttonClear, *buttonDone;
+           *buttonEraser, *buttonImport, *buttonExport, *buttonAnalyze, *buttonErase, *buttonClear, *buttonDone;
     QString buttonStylePrimary, buttonStyleHighlighted;
     
     friend class Generator;
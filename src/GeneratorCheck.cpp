@@ -0,0 +1,103 @@
+#include "GeneratorCheck.h"
+#include "MoveGenerator.h"
+#include "Notation.h"
+#include <QStringList>
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+
+namespace
+{
+
+using Position = GeneratorCheck::Position;
+
+bool isBefore(const Move &a, const Move &b)
+{
+    return std::tie(a.start, a.end, a.captured, a.promotion) < std::tie(b.start, b.end, b.captured, b.promotion);
+}
+
+QString describe(const vector<Move> &moves)
+{
+    QStringList res;
+    for (auto &move : moves)
+        res << Notation::move(move) + (move.promotion ? "K" : "");
+    return res.join(' ');
+}
+
+}
+
+Position GeneratorCheck::toVariant(const GameEngine &engine)
+{
+    Position position;
+    position.setSideToMove(engine.whoseTurn());
+    for (int square = 0; square < Position::Squares; ++square)
+    {
+        auto &cell = engine.board.get(square);
+        if (cell.isEmpty())
+            continue;
+        position.setPiece(square, uint8_t((cell.isKing() ? Position::King : Position::Man) |
+                                          (cell.occupier() == 1 ? Position::Side1 : 0)));
+    }
+    return position;
+}
+
+GameEngine GeneratorCheck::toEngine(const Position &position)
+{
+    GameEngine engine(position.sideToMove(), position.sideToMove());
+    for (int square = 0; square < Position::Squares; ++square)
+    {
+        uint8_t piece = position.piece(square);
+        auto &cell = engine.board.get(square);
+        if (piece == Position::Empty)
+            cell.setOccupier(-1);
+        else
+            cell.setOccupier(piece & Position::Side1 ? 1 : 0, piece & Position::King);
+    }
+    return engine;
+}
+
+Move GeneratorCheck::toMove(const Position::Move &move)
+{
+    Move res;
+    res.start = move.from;
+    res.end = move.to;
+    res.promotion = move.promotion;
+    for (auto square : move.captured)
+        res.captured |= uint64_t(1) << Move::bit(square);
+    return res;
+}
+
+QString GeneratorCheck::compare(const GameEngine &engine)
+{
+    Arena::Scope scope;
+    auto position = toVariant(engine);
+    auto variantMoves = position.generate();
+
+    vector<Move> dfs, variant;
+    for (auto &move : MoveGenerator::generate(engine))
+        dfs.push_back(move);
+    for (auto &move : variantMoves)
+        variant.push_back(toMove(move));
+    std::sort(dfs.begin(), dfs.end(), isBefore);
+    std::sort(variant.begin(), variant.end(), isBefore);
+
+    vector<Move> onlyDfs, onlyVariant;
+    std::set_difference(dfs.begin(), dfs.end(), variant.begin(), variant.end(), std::back_inserter(onlyDfs), isBefore);
+    std::set_difference(variant.begin(), variant.end(), dfs.begin(), dfs.end(), std::back_inserter(onlyVariant), isBefore);
+    if (dfs.size() != variant.size() || !onlyDfs.empty() || !onlyVariant.empty())
+        return QString("%1 moves from the dfs, %2 from VariantPosition; only the dfs: %3; only VariantPosition: %4")
+                .arg(dfs.size()).arg(variant.size()).arg(describe(onlyDfs)).arg(describe(onlyVariant));
+
+    for (auto &move : variantMoves)
+    {
+        auto expected = position;
+        expected.play(move);
+        auto played = toVariant(MoveGenerator::play(engine, toMove(move)));
+        bool same = played.sideToMove() == expected.sideToMove();
+        for (int square = 0; square < Position::Squares; ++square)
+            same = same && played.piece(square) == expected.piece(square);
+        if (!same)
+            return QString("the positions after %1 differ").arg(Notation::move(toMove(move)));
+    }
+    return QString();
+}
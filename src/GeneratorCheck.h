@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QString>
+#include "GameEngine.h"
+#include "MoveGenerator.h"
+#include "VariantPosition.h"
+
+// Differential check of the move generators: MoveGenerator, on the engine's
+// dfs, against VariantPosition for the same rules. Both have to find the same
+// packed moves and play them to the same positions, so neither can be
+// optimized into different rules unnoticed. The fuzzer and draughts-difftest
+// run it on as many positions as they can. The conversions between the two
+// are here too, for the code that plays on VariantPosition for speed.
+class GeneratorCheck
+{
+public:
+    using Position = VariantPosition<GameEngine::Rules>;
+
+    static Position toVariant(const GameEngine &engine);
+    static GameEngine toEngine(const Position &position);
+    static Move toMove(const Position::Move &move);
+    // the first difference found, empty when the generators agree; the
+    // engine must not be finished
+    static QString compare(const GameEngine &engine);
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Diagonal geometry of the board computed at compile time, so the move
+// generator walks tables instead of stepping coordinates and checking the
+// edges at every step, for any board size. Squares are numbered x * Size + y
+// like GameEngine::Board. The directions keep the order of the old dx/dy arrays:
+// the first two go towards row 0, which is forward for the side to move.
+namespace Geometry
+{
+
+constexpr int Directions = 4;
+constexpr int dx[Directions] = {-1, -1, 1, 1};
+constexpr int dy[Directions] = {1, -1, 1, -1};
+
+constexpr int None = -1;
+
+// a set of squares, one bit per square
+template<int Squares>
+struct Mask
+{
+    std::array<uint64_t, (Squares + 63) / 64> words{};
+
+    constexpr void set(int square)
+    {
+        words[square / 64] |= uint64_t(1) << (square % 64);
+    }
+
+    constexpr bool test(int square) const
+    {
+        return (words[square / 64] >> (square % 64)) & 1;
+    }
+};
+
+// the squares from one square to the edge in one direction, nearest first
+template<int Size>
+struct Ray
+{
+    int length = 0;
+    std::array<uint8_t, Size - 1> squares{};
+};
+
+// the squares strictly between two squares on a diagonal, part of a ray
+struct Segment
+{
+    const uint8_t *first = nullptr, *last = nullptr;
+
+    const uint8_t *begin() const { return first; }
+    const uint8_t *end() const { return last; }
+};
+
+template<int Size>
+struct Tables
+{
+    static constexpr int Squares = Size * Size;
+    static_assert(Squares <= 256, "rays keep squares in a byte");
+
+    std::array<std::array<Ray<Size>, Directions>, Squares> rays{};
+    std::array<std::array<Mask<Squares>, Directions>, Squares> masks{}; // the squares of each ray
+
+    constexpr Tables()
+    {
+        for (int x = 0; x < Size; ++x)
+            for (int y = 0; y < Size; ++y)
+                for (int k = 0; k < Directions; ++k)
+                {
+                    int square = x * Size + y;
+                    auto &ray = rays[square][k];
+                    for (int xx = x + dx[k], yy = y + dy[k];
+                         xx >= 0 && yy >= 0 && xx < Size && yy < Size;
+                         xx += dx[k], yy += dy[k])
+                    {
+                        ray.squares[ray.length++] = uint8_t(xx * Size + yy);
+                        masks[square][k].set(xx * Size + yy);
+                    }
+                }
+    }
+
+    // the direction leading from one square to the other, None if they
+    // aren't on a diagonal
+    constexpr int direction(int from, int to) const
+    {
+        for (int k = 0; k < Directions; ++k)
+            if (masks[from][k].test(to))
+                return k;
+        return None;
+    }
+
+    Segment between(int from, int to) const
+    {
+        int k = direction(from, to);
+        if (k == None)
+            return Segment{};
+        auto &ray = rays[from][k];
+        int distance = 0;
+        while (ray.squares[distance] != to)
+            ++distance;
+        return Segment{ray.squares.data(), ray.squares.data() + distance};
+    }
+};
+
+// one instance per board size, only those used are compiled in
+template<int Size>
+inline constexpr Tables<Size> tables;
+
+static_assert(tables<10>.rays[0][2].length == 9 && tables<10>.rays[0][2].squares[8] == 99, "the long diagonal");
+static_assert(tables<10>.rays[0][0].length == 0 && tables<10>.rays[11][2].squares[1] == 33, "edges and jumps");
+static_assert(tables<10>.direction(99, 0) == 1 && tables<8>.direction(0, 63) == 2 && tables<10>.direction(0, 1) == None, "directions");
+
+}
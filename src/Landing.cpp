@@ -51,12 +51,14 @@ void Landing::clicked(const QString &text)
 {
     if (text == "Create Game vs. AI")
     {
+        CreateGameDialog *dialog = new CreateGameDialog(CreateGameDialog::VersusAI, this);
+        if (dialog->exec() == QDialog::Rejected) return;
         generator->reset();
-        emit createGameVsAI(generator->engine());
+        emit createGameVsAI(generator->engine(), dialog->difficulty());
     }
     else if (text == "Create Online Game")
     {
-        CreateGameDialog *dialog = new CreateGameDialog(this);
+        CreateGameDialog *dialog = new CreateGameDialog(CreateGameDialog::Online, this);
         if (dialog->exec() == QDialog::Rejected) return;
         else
         {
@@ -72,7 +74,7 @@ void Landing::clicked(const QString &text)
                 if (generator->exec() != QDialog::Accepted)
                     return;
             }
-            emit createGame(dialog->nickname(), dialog->ip(), dialog->port(), generator->engine());
+            emit createGame(dialog->nickname(), dialog->ip(), dialog->port(), generator->engine(), dialog->timeControl());
         }
     }
     else if (text == "Join Game")
@@ -23,6 +23,7 @@
 
 #include "Common.h"
 #include "Generator.h"
+#include "Difficulty.h"
 
 class LandingButtons : public Widget
 {
@@ -49,8 +50,8 @@ private slots:
     void clicked(const QString &text);
 
 signals:
-    void createGameVsAI(const GameEngine &engine);
-    void createGame(QString nickname, QString ip, int port, const GameEngine &engine);
+    void createGameVsAI(const GameEngine &engine, Difficulty::Level level);
+    void createGame(QString nickname, QString ip, int port, const GameEngine &engine, TimeControl timeControl);
     void joinGame(QString nickname, QString ip, int port);
     
 private:
@@ -0,0 +1,203 @@
+#include "Logger.h"
+#include "Config.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+Q_LOGGING_CATEGORY(lcNet, "draughts.net")
+Q_LOGGING_CATEGORY(lcAI, "draughts.ai")
+Q_LOGGING_CATEGORY(lcGame, "draughts.game")
+
+namespace
+{
+
+const int FLUSH_INTERVAL = 20; // ms the flusher sleeps when there is nothing to write
+
+qint64 now()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// UTF-8 of text into out, as many whole characters as fit; the bytes written
+int encode(const QString &text, char *out, int capacity, bool &truncated)
+{
+    int length = 0;
+    const QChar *it = text.constData(), *end = it + text.size();
+    while (it != end)
+    {
+        uint code = it->unicode();
+        int next = 1;
+        if (it->isHighSurrogate() && it + 1 != end && it[1].isLowSurrogate())
+        {
+            code = QChar::surrogateToUcs4(*it, it[1]);
+            next = 2;
+        }
+        else if (it->isSurrogate())
+            code = QChar::ReplacementCharacter;
+        int size = code < 0x80 ? 1 : code < 0x800 ? 2 : code < 0x10000 ? 3 : 4;
+        if (length + size > capacity)
+            break;
+        if (size == 1)
+            out[length] = char(code);
+        else
+        {
+            static const uchar lead[] = {0, 0, 0xc0, 0xe0, 0xf0};
+            for (int k = size - 1; k > 0; --k, code >>= 6)
+                out[length + k] = char(0x80 | (code & 0x3f));
+            out[length] = char(lead[size] | code);
+        }
+        length += size;
+        it += next;
+    }
+    truncated = it != end;
+    return length;
+}
+
+}
+
+std::atomic<int> Logger::level{Config::MSG_LEVEL};
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+{
+    for (size_t i = 0; i < Capacity; ++i)
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    now();
+    flusher = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger()
+{
+    stopping = true;
+    wake.notify_one();
+    flusher.join();
+    flush();
+    // anything logged during the rest of the shutdown goes straight to stderr
+    qInstallMessageHandler(nullptr);
+}
+
+void Logger::setLevel(int level)
+{
+    Logger::level = level;
+    // disabled levels are then skipped by the qC* macros before formatting
+    QString rules;
+    const char *names[] = {"debug", "warning", "critical", "fatal", "info"};
+    for (int type = QtDebugMsg; type <= QtInfoMsg; ++type)
+        if (type != QtFatalMsg)
+            rules += QString("*.%1=%2\n").arg(names[type]).arg(type >= level ? "true" : "false");
+    QLoggingCategory::setFilterRules(rules);
+}
+
+bool Logger::isEnabled(QtMsgType type)
+{
+    return type == QtFatalMsg || type >= level.load(std::memory_order_relaxed);
+}
+
+void Logger::log(QtMsgType type, const QString &message)
+{
+    if (!isEnabled(type))
+        return;
+    // only chatter may be lost, problems are worth waiting for the flusher
+    bool pushed = push(type, message);
+    if (!pushed && type != QtDebugMsg && type != QtInfoMsg)
+    {
+        flush();
+        pushed = push(type, message);
+    }
+    if (!pushed)
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    if (type == QtFatalMsg)
+        flush();
+}
+
+// Vyukov's bounded queue: a slot is free for the producer claiming position
+// pos when its sequence is pos, and ready for the consumer when it is pos + 1
+bool Logger::push(QtMsgType type, const QString &message)
+{
+    size_t pos = tail.load(std::memory_order_relaxed);
+    Slot *slot;
+    for (;;)
+    {
+        slot = &ring[pos & (Capacity - 1)];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = intptr_t(sequence) - intptr_t(pos);
+        if (diff == 0)
+        {
+            if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+            return false; // full
+        else
+            pos = tail.load(std::memory_order_relaxed);
+    }
+
+    slot->type = type;
+    slot->time = now();
+    slot->length = encode(message, slot->text, MaxMessage, slot->truncated);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+size_t Logger::drain()
+{
+    static const char *types[] = {"Debug", "Warning", "Critical", "Fatal", "Info"};
+    char line[MaxMessage + 64];
+    size_t count = 0;
+    for (;;)
+    {
+        Slot &slot = ring[head & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+            break;
+        int prefix = snprintf(line, 64, "[%9.3f] %s: ", slot.time / 1e6, types[slot.type]);
+        memcpy(line + prefix, slot.text, size_t(slot.length));
+        int length = prefix + slot.length;
+        if (slot.truncated)
+        {
+            memcpy(line + length, "...", 3);
+            length += 3;
+        }
+        line[length++] = '\n';
+        slot.sequence.store(head + Capacity, std::memory_order_release);
+        ++head;
+        ++count;
+        fwrite(line, 1, size_t(length), stderr);
+    }
+
+    int64_t lost = dropped.exchange(0, std::memory_order_relaxed);
+    if (lost)
+        fprintf(stderr, "[%9.3f] Warning: %lld log messages dropped\n", now() / 1e6, (long long)lost);
+    if (count || lost)
+        fflush(stderr);
+    return count;
+}
+
+void Logger::flush()
+{
+    std::lock_guard<std::mutex> lock(consumerMutex);
+    drain();
+}
+
+void Logger::run()
+{
+    while (!stopping)
+    {
+        size_t count;
+        {
+            std::lock_guard<std::mutex> lock(consumerMutex);
+            count = drain();
+        }
+        if (!count)
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, std::chrono::milliseconds(FLUSH_INTERVAL), [this] { return bool(stopping); });
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <QLoggingCategory>
+#include <QString>
+
+Q_DECLARE_LOGGING_CATEGORY(lcNet)
+Q_DECLARE_LOGGING_CATEGORY(lcAI)
+Q_DECLARE_LOGGING_CATEGORY(lcGame)
+
+// Asynchronous log sink behind MsgHandler. Any thread appends a record to a
+// bounded lock-free ring (multiple producers, one consumer) without taking a
+// lock or allocating, encoding the message as UTF-8 straight into its
+// record; a background thread formats and writes the records to
+// stderr in batches. When the ring is full, debug and info records are
+// dropped and counted rather than blocking the caller, while warnings and
+// worse wait for it to be drained. Fatal messages are written synchronously,
+// as the process is about to abort.
+//
+// Use the categorised macros (qCInfo(lcNet, ...)): they check whether the
+// level is enabled before the arguments are even evaluated.
+class Logger
+{
+public:
+    static Logger &instance();
+    ~Logger();
+
+    // messages of types below level are filtered out, in QtMsgType's order
+    // like Config::MSG_LEVEL
+    static void setLevel(int level);
+    static bool isEnabled(QtMsgType type);
+
+    void log(QtMsgType type, const QString &message);
+    void flush();
+
+private:
+    static constexpr size_t Capacity = 1024; // power of two
+    static constexpr int MaxMessage = 480;    // bytes of UTF-8 kept per record
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        QtMsgType type;
+        int length;
+        bool truncated;
+        qint64 time;
+        char text[MaxMessage];
+    };
+
+    Logger();
+    bool push(QtMsgType type, const QString &message);
+    void run();
+    size_t drain(); // the consumer side, under consumerMutex
+
+    Slot ring[Capacity]; // not "slots", which Qt defines as a keyword
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) size_t head = 0;
+    std::atomic<int64_t> dropped{0};
+
+    std::mutex consumerMutex;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+    std::thread flusher;
+
+    static std::atomic<int> level;
+};
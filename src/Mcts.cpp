@@ -0,0 +1,336 @@
+#include "Mcts.h"
+#include "Profiler.h"
+#include "Random.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+struct Mcts::Node
+{
+    enum State
+    {
+        Leaf,
+        Expanding,
+        Expanded
+    };
+
+    Move move; // from the parent
+    float prior = 0;
+    int count = 0;             // of the children, set before the state is Expanded
+    Node *children = nullptr;
+    std::atomic<int> state{Leaf};
+    std::atomic<int> visits{0};   // with the ones still on their way down
+    std::atomic<qint64> value{0}; // half points of the side that played move
+
+    void reset(const Move &from, float p)
+    {
+        move = from;
+        prior = p;
+        count = 0;
+        children = nullptr;
+        state.store(Leaf, std::memory_order_relaxed);
+        visits.store(0, std::memory_order_relaxed);
+        value.store(0, std::memory_order_relaxed);
+    }
+};
+
+namespace
+{
+
+using Position = Mcts::Position;
+
+// half points, as the nodes count them
+constexpr int Win = 2, Draw = 1, Loss = 0;
+
+void play(Position &position, const Move &move)
+{
+    uint8_t piece = position.piece(move.start);
+    position.setPiece(move.start, Position::Empty);
+    for (uint64_t mask = move.captured; mask; mask &= mask - 1)
+        position.setPiece(Move::square(qCountTrailingZeroBits(mask)), Position::Empty);
+    position.setPiece(move.end, move.promotion ? uint8_t((piece & Position::Side1) | Position::King) : piece);
+    position.setSideToMove(position.sideToMove() ^ 1);
+}
+
+// men count one, kings three, for the side to move
+int material(const Position &position)
+{
+    int res = 0;
+    for (int square = 0; square < Position::Squares; ++square)
+    {
+        uint8_t piece = position.piece(square);
+        if (piece == Position::Empty)
+            continue;
+        int worth = piece & Position::King ? 3 : 1;
+        res += (piece & Position::Side1 ? 1 : 0) == position.sideToMove() ? worth : -worth;
+    }
+    return res;
+}
+
+// a winning rate as a score in the units of the evaluation
+int toScore(double rate)
+{
+    rate = std::min(std::max(rate, 0.001), 0.999);
+    return int(std::lround(400 * std::log10(rate / (1 - rate))));
+}
+
+}
+
+Mcts::Mcts(const Settings &settings, const Evaluation &evaluation)
+    : evaluation(evaluation), settings(settings)
+{
+    // the root and its children at least
+    capacity = std::max<size_t>(size_t(settings.memoryMegabytes) * 1024 * 1024 / sizeof(Node), MoveGenerator::MaxMoves + 1);
+    pool.reset(new Node[capacity]);
+}
+
+Mcts::~Mcts() = default;
+
+quint64 Mcts::ticket()
+{
+    return ++tickets;
+}
+
+void Mcts::stop()
+{
+    quint64 last = tickets.load(), current = cancelled.load();
+    while (current < last && !cancelled.compare_exchange_weak(current, last))
+        ;
+    stopped = true;
+}
+
+qint64 Mcts::progress() const
+{
+    return playouts.load(std::memory_order_relaxed);
+}
+
+// true when the node has its children, whoever expanded it
+bool Mcts::expand(Node &node, const Position &position)
+{
+    if (used.load(std::memory_order_relaxed) >= capacity)
+        return false;
+    int expected = Node::Leaf;
+    if (!node.state.compare_exchange_strong(expected, Node::Expanding, std::memory_order_acquire))
+        return expected == Node::Expanded;
+
+    auto moves = position.generate();
+    size_t first = used.fetch_add(moves.size(), std::memory_order_relaxed);
+    if (first + moves.size() > capacity)
+    {
+        node.state.store(Node::Leaf, std::memory_order_release);
+        return false;
+    }
+
+    std::vector<double> priors(moves.size(), 1.0 / std::max<size_t>(moves.size(), 1));
+    if (settings.temperature > 0 && moves.size() > 1)
+    {
+        Arena::Scope scope;
+        auto engine = GeneratorCheck::toEngine(position);
+        double best = -Search::Infinity, sum = 0;
+        for (size_t k = 0; k < moves.size(); ++k)
+        {
+            priors[k] = -evaluation(MoveGenerator::play(engine, GeneratorCheck::toMove(moves[k])));
+            best = std::max(best, priors[k]);
+        }
+        for (auto &prior : priors)
+            sum += prior = std::exp((prior - best) / settings.temperature);
+        for (auto &prior : priors)
+            prior /= sum;
+    }
+
+    Node *children = &pool[first];
+    for (size_t k = 0; k < moves.size(); ++k)
+        children[k].reset(GeneratorCheck::toMove(moves[k]), float(priors[k]));
+    node.children = children;
+    node.count = int(moves.size());
+    node.state.store(Node::Expanded, std::memory_order_release);
+    return true;
+}
+
+Mcts::Node *Mcts::select(Node &node) const
+{
+    int visits = node.visits.load(std::memory_order_relaxed);
+    qint64 value = node.value.load(std::memory_order_relaxed);
+    double factor = settings.exploration * std::sqrt(double(std::max(visits, 1)));
+    // unvisited children start from the rate of the side to move here
+    double unvisited = visits ? 1 - double(value) / (2.0 * visits) : 0.5;
+
+    Node *best = nullptr;
+    double bestScore = -1;
+    for (int k = 0; k < node.count; ++k)
+    {
+        Node &child = node.children[k];
+        int n = child.visits.load(std::memory_order_relaxed);
+        double rate = n ? double(child.value.load(std::memory_order_relaxed)) / (2.0 * n) : unvisited;
+        double score = rate + factor * child.prior / (1 + n);
+        if (score > bestScore)
+        {
+            best = &child;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+// the result for the side to move
+int Mcts::playout(Position position, uint64_t &random) const
+{
+    int side = position.sideToMove();
+    for (int ply = 0; ply < PlayoutPlies; ++ply)
+    {
+        auto moves = position.generate();
+        if (moves.empty())
+            return position.sideToMove() == side ? Loss : Win;
+        position.play(moves[splitmix64(random) % moves.size()]);
+    }
+    int balance = material(position);
+    if (position.sideToMove() != side)
+        balance = -balance;
+    return balance > 0 ? Win : balance < 0 ? Loss : Draw;
+}
+
+void Mcts::work(int thread)
+{
+    uint64_t random = settings.seed ^ (uint64_t(thread + 1) * 0xd1b54a32d192ed03ull);
+    FixedVector<Node *, MaxDepth + 1> path;
+    int deepest = 0;
+    for (int iteration = 0; !stopped.load(std::memory_order_relaxed); ++iteration)
+    {
+        if (cancelled.load(std::memory_order_relaxed) >= running)
+        {
+            stopped = true;
+            break;
+        }
+        qint64 started = playouts.fetch_add(1, std::memory_order_relaxed);
+        // a playout is short, so the move gets its soft budget like an
+        // iteration of Search; the hard limit only backs it up
+        bool outOfTime = (iteration & 15) == 0 && (timeManager.isSoftLimitReached() || timeManager.isHardLimitReached());
+        if ((limits.nodes && started >= limits.nodes) || outOfTime)
+        {
+            playouts.fetch_sub(1, std::memory_order_relaxed);
+            stopped = true;
+            break;
+        }
+
+        Position position = rootPosition;
+        Node *node = &pool[0];
+        node->visits.fetch_add(1, std::memory_order_relaxed);
+        path.clear();
+        path.push_back(node);
+        bool terminal = false, expanded = false;
+        for (;;)
+        {
+            int state = node->state.load(std::memory_order_acquire);
+            // one new node per playout
+            if (state == Node::Leaf && !expanded && path.size() <= MaxDepth && expand(*node, position))
+            {
+                state = Node::Expanded;
+                expanded = true;
+            }
+            if (state != Node::Expanded)
+                break;
+            if (node->count == 0)
+            {
+                terminal = true;
+                break;
+            }
+            node = select(*node);
+            // the visit counts as a loss until the result comes back
+            node->visits.fetch_add(1, std::memory_order_relaxed);
+            play(position, node->move);
+            path.push_back(node);
+        }
+        deepest = std::max(deepest, int(path.size()) - 1);
+
+        // each node keeps the result of the side that moved into it
+        int result = terminal ? Loss : playout(position, random);
+        for (size_t k = path.size(); k-- > 0;)
+        {
+            result = Win - result;
+            path[k]->value.fetch_add(result, std::memory_order_relaxed);
+        }
+    }
+
+    int current = depth.load();
+    while (deepest > current && !depth.compare_exchange_weak(current, deepest))
+        ;
+}
+
+// the most visited line after the first move
+vector<Move> Mcts::principalVariation(const Node &first) const
+{
+    vector<Move> pv;
+    const Node *node = &first;
+    pv.push_back(node->move);
+    while (node->state.load() == Node::Expanded && node->count > 0)
+    {
+        auto next = std::max_element(node->children, node->children + node->count, [](const Node &a, const Node &b) {
+            return a.visits.load() < b.visits.load();
+        });
+        if (next->visits.load() == 0)
+            break;
+        node = next;
+        pv.push_back(node->move);
+    }
+    return pv;
+}
+
+Search::Result Mcts::run(const GameEngine &root, const Search::Limits &limits, quint64 ticket)
+{
+    PROFILE_SCOPE("mcts.run");
+    if (limits.moveTime)
+        timeManager.startFixed(limits.moveTime);
+    else if (limits.time)
+        timeManager.start(limits.time, limits.increment, limits.movesToGo);
+    else
+        timeManager.startInfinite();
+    this->limits = limits;
+    running = ticket ? ticket : this->ticket();
+    stopped = cancelled.load() >= running;
+    playouts = 0;
+    depth = 0;
+
+    Search::Result result;
+    rootPosition = GeneratorCheck::toVariant(root);
+    Node &rootNode = pool[0];
+    rootNode.reset(Move(), 1);
+    used = 1;
+    expand(rootNode, rootPosition);
+    // nothing to think about without a choice, nor once stopped
+    if (rootNode.count > 1 && !stopped)
+    {
+        int threads = settings.threads > 0 ? settings.threads : int(std::thread::hardware_concurrency());
+        std::vector<std::thread> workers;
+        for (int thread = 1; thread < threads; ++thread)
+            workers.emplace_back(&Mcts::work, this, thread);
+        work(0);
+        for (auto &worker : workers)
+            worker.join();
+    }
+
+    std::vector<const Node *> children;
+    for (int k = 0; k < rootNode.count; ++k)
+        children.push_back(&rootNode.children[k]);
+    std::stable_sort(children.begin(), children.end(), [](const Node *a, const Node *b) {
+        return a->visits.load() > b->visits.load();
+    });
+    for (int k = 0; k < std::min(int(children.size()), std::max(limits.multiPV, 1)); ++k)
+    {
+        auto &child = *children[k];
+        int visits = child.visits.load();
+        int score = visits ? toScore(double(child.value.load()) / (2.0 * visits)) : 0;
+        result.lines.push_back(Search::Line{score, principalVariation(child)});
+    }
+    if (!result.lines.empty())
+    {
+        result.best = children.front()->move;
+        result.score = result.lines.front().score;
+    }
+    result.depth = depth;
+    result.nodes = playouts;
+    result.time = timeManager.elapsed();
+    PROFILE_COUNT("mcts.playouts", result.nodes);
+    PROFILE_COUNT("mcts.tree", qint64(std::min(used.load(), capacity)));
+    return result;
+}
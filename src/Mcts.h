@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "GeneratorCheck.h"
+#include "Search.h"
+
+// Monte Carlo tree search for engine.whoseTurn(), the alternative to Search
+// where the evaluation is too weak to trust at the leaves. Every iteration
+// walks down the tree by PUCT, expands the leaf it reaches and scores it by a
+// random playout on VariantPosition, the fastest generator. The evaluation
+// only gives the priors of the children; with a temperature of 0 they are
+// uniform and the selection is plain UCT.
+//
+// The threads share one tree. A thread adds a visit to every node on its way
+// down and the result on its way back, so until then the node counts as lost
+// to the others (virtual loss) and they spread over other lines. Expanding a
+// node takes its children from a pool with one atomic add and publishes them
+// with one compare and swap; a thread that finds a node being expanded plays
+// out from it instead of waiting. Once the pool is full the tree stops
+// growing and the playouts go on from its leaves.
+//
+// Playouts know no draw rules; after PlayoutPlies moves the material decides.
+class Mcts
+{
+public:
+    using Position = GeneratorCheck::Position;
+
+    static constexpr int PlayoutPlies = 150;
+    static constexpr int MaxDepth = 256; // of the tree, deeper leaves aren't expanded
+
+    struct Settings
+    {
+        int threads = 0;          // 0 for one per core
+        int memoryMegabytes = 64; // for the tree
+        double exploration = 1.5; // the c of PUCT
+        double temperature = 150; // of the softmax over the children's scores, 0 for uniform priors
+        uint64_t seed = 1;
+    };
+
+    explicit Mcts(const Settings &settings, const Evaluation &evaluation = Evaluation());
+    ~Mcts();
+
+    // limits.nodes counts playouts and limits.depth is ignored; result.depth
+    // is the deepest line of the tree and result.nodes the playouts. Tickets
+    // work as for Search::run(): a run queued on another thread takes one
+    // before, so a stop() in between isn't lost
+    Search::Result run(const GameEngine &root, const Search::Limits &limits, quint64 ticket = 0);
+    quint64 ticket();
+    void stop(); // stops the running search and every ticket taken; may be called from any thread
+    // playouts so far by the running search, safe to read from any thread
+    qint64 progress() const;
+
+private:
+    struct Node;
+
+    void work(int thread);
+    bool expand(Node &node, const Position &position);
+    Node *select(Node &node) const;
+    int playout(Position position, uint64_t &random) const;
+    vector<Move> principalVariation(const Node &first) const;
+
+    Evaluation evaluation;
+    Settings settings;
+    std::unique_ptr<Node[]> pool;
+    size_t capacity = 0;
+    std::atomic<size_t> used{0};
+    Position rootPosition;
+    Search::Limits limits;
+    TimeManager timeManager;
+    std::atomic<bool> stopped{false};
+    std::atomic<quint64> tickets{0}, cancelled{0}; // the last ticket taken, the last one stopped
+    quint64 running = 0; // ticket of the current run
+    std::atomic<qint64> playouts{0};
+    std::atomic<int> depth{0};
+};
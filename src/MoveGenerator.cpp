@@ -0,0 +1,218 @@
+#include "MoveGenerator.h"
+#include "GameEngine.h"
+#include "Geometry.h"
+#include <QStringList>
+#include <QtAlgorithms>
+#include <algorithm>
+
+namespace
+{
+
+constexpr int Size = GameEngine::Size;
+constexpr auto &tables = Geometry::tables<Size>;
+
+QPoint cell(int square)
+{
+    return QPoint(square / Size, square % Size);
+}
+
+int square(QPoint p)
+{
+    return p.x() * Size + p.y();
+}
+
+}
+
+QPoint Move::from() const
+{
+    return cell(start);
+}
+
+QPoint Move::to() const
+{
+    return cell(end);
+}
+
+int Move::captures() const
+{
+    return qPopulationCount(captured);
+}
+
+FixedVector<int, GameEngine::MaxCaptures> Move::capturedSquares() const
+{
+    FixedVector<int, GameEngine::MaxCaptures> res;
+    for (uint64_t rest = captured; rest; rest &= rest - 1)
+        res.push_back(square(qCountTrailingZeroBits(rest)));
+    return res;
+}
+
+bool Move::operator==(const Move &other) const
+{
+    return start == other.start && end == other.end && captured == other.captured;
+}
+
+QString Move::pack() const
+{
+    return QString("%1 %2 %3 %4").arg(start).arg(end).arg(qulonglong(captured), 0, 16).arg(int(promotion));
+}
+
+bool Move::unpack(const QString &text, Move &move)
+{
+    auto parts = text.split(' ', QString::SkipEmptyParts);
+    if (parts.size() != 4)
+        return false;
+    bool ok[4];
+    int start = parts[0].toInt(&ok[0]), end = parts[1].toInt(&ok[1]);
+    uint64_t captured = parts[2].toULongLong(&ok[2], 16);
+    int promotion = parts[3].toInt(&ok[3]);
+    if (!ok[0] || !ok[1] || !ok[2] || !ok[3])
+        return false;
+    if (start < 0 || start >= Size * Size || end < 0 || end >= Size * Size || promotion < 0 || promotion > 1)
+        return false;
+    if (captured >> (Size * Size / 2))
+        return false;
+    move.start = uint8_t(start);
+    move.end = uint8_t(end);
+    move.captured = captured;
+    move.promotion = promotion;
+    return true;
+}
+
+MoveKey::MoveKey(const Move &move)
+    : from(move.start), to(move.end)
+{
+
+}
+
+bool MoveKey::isNull() const
+{
+    return from == 0xff;
+}
+
+bool MoveKey::matches(const Move &move) const
+{
+    return *this == MoveKey(move);
+}
+
+bool MoveKey::operator==(MoveKey other) const
+{
+    return from == other.from && to == other.to;
+}
+
+// follows every continuation of a capture, the engine only tells one hop at a time
+static void extend(const GameEngine &engine, Move move, QPoint S, QPoint E, MoveGenerator::MoveList &moves)
+{
+    auto position = engine;
+    MoveGenerator::addHop(position, move, S, E);
+    bool hasDied = position.move(S, E);
+
+    auto next = hasDied ? position.nextCells(E.x(), E.y(), true) : GameEngine::Cells{};
+    if (next.empty())
+    {
+        // going round a cycle of at least four pieces takes the same ones
+        // either way, which is the same move
+        if (move.captures() >= 4 && std::find(moves.begin(), moves.end(), move) != moves.end())
+            return;
+        moves.push_back(move);
+    }
+    for (auto N : next)
+        extend(position, move, E, N, moves);
+}
+
+MoveGenerator::MoveList MoveGenerator::generate(const GameEngine &engine)
+{
+    MoveList moves(MaxMoves);
+    generate(engine, moves);
+    return moves;
+}
+
+void MoveGenerator::generate(const GameEngine &engine, MoveList &moves)
+{
+    auto position = engine;
+    if (!position.updateMovable())
+        return;
+
+    for (int i = 0; i < Size; ++i)
+        for (int j = 0; j < Size; ++j)
+            if (position.board.get(i, j).isMovable())
+                for (auto E : position.nextCells(i, j))
+                    extend(position, Move{}, QPoint(i, j), E, moves);
+}
+
+GameEngine MoveGenerator::play(const GameEngine &engine, const Move &move)
+{
+    auto position = engine;
+    auto &start = position.board.get(move.start);
+    int occupier = start.occupier();
+    bool king = start.isKing() || move.promotion;
+    start.setOccupier(-1);
+    for (int square : move.capturedSquares())
+        position.board.get(square).setOccupier(-1);
+    position.board.get(move.end).setOccupier(occupier, king);
+    position.switchWhoseTurn();
+    return position;
+}
+
+void MoveGenerator::addHop(const GameEngine &before, Move &move, QPoint S, QPoint E)
+{
+    int from = square(S), to = square(E);
+    if (move.isNull())
+        move.start = uint8_t(from);
+    for (int jumped : tables.between(from, to))
+        if (!before.board.get(jumped).isEmpty())
+        {
+            move.captured |= uint64_t(1) << Move::bit(jumped);
+            break;
+        }
+    move.end = uint8_t(to);
+    // men promote when the move ends on the far row, not on the way
+    auto &piece = before.board.get(from);
+    move.promotion = !piece.isKing() && E.x() == (piece.occupier() == 0 ? 0 : Size - 1);
+}
+
+// A path that takes exactly the pieces left in remaining and ends where the
+// move does. Taken pieces stay on the board until the move is over, so they
+// block the way as the rules want.
+static bool findHops(const GameEngine &engine, const Move &move, int square, uint64_t remaining, int maxStep,
+                     FixedVector<QPoint, GameEngine::MaxCaptures + 1> &path)
+{
+    if (!remaining)
+        return square == move.end;
+    // the moving piece has left its square
+    auto isFree = [&](int s) { return s == move.start || engine.board.get(s).isEmpty(); };
+    for (auto &ray : tables.rays[square])
+    {
+        int reach = std::min(ray.length, maxStep), step = 0;
+        while (step < reach && isFree(ray.squares[step]))
+            ++step;
+        if (step == reach)
+            continue;
+        uint64_t victim = uint64_t(1) << Move::bit(ray.squares[step]);
+        if (!(remaining & victim))
+            continue;
+        int end = std::min(ray.length, step + 1 + maxStep);
+        for (int next = step + 1; next < end && isFree(ray.squares[next]); ++next)
+        {
+            path.push_back(cell(ray.squares[next]));
+            if (findHops(engine, move, ray.squares[next], remaining & ~victim, maxStep, path))
+                return true;
+            path.pop_back();
+        }
+    }
+    return false;
+}
+
+FixedVector<QPoint, GameEngine::MaxCaptures + 1> MoveGenerator::hops(const GameEngine &engine, const Move &move)
+{
+    FixedVector<QPoint, GameEngine::MaxCaptures + 1> path;
+    path.push_back(move.from());
+    if (!move.captured)
+        path.push_back(move.to());
+    else
+    {
+        auto &piece = engine.board.get(move.start);
+        int maxStep = piece.isKing() && GameEngine::Rules::FlyingKings ? Size - 1 : 1;
+        findHops(engine, move, move.start, move.captured, maxStep, path);
+    }
+    return path;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <QPoint>
+#include <QString>
+#include "Arena.h"
+#include "GameEngine.h"
+
+// A complete move in 16 bytes: the start and end squares (x * Size + y), the
+// pieces taken as a mask over the dark squares and whether a man promotes.
+// Capture sequences taking the same pieces between the same squares are one
+// move under the rules, so the landing squares in between aren't kept;
+// MoveGenerator::hops() finds them again for the views.
+struct Move
+{
+    static constexpr uint8_t NoSquare = 0xff;
+
+    uint64_t captured = 0; // bit(square) of every piece taken
+    uint8_t start = NoSquare, end = NoSquare;
+    bool promotion = false;
+
+    // the dark squares numbered row by row, half of the board
+    static constexpr int bit(int square) { return square / 2; }
+    static constexpr int square(int bit)
+    {
+        int x = bit / (GameEngine::Size / 2);
+        return x * GameEngine::Size + bit % (GameEngine::Size / 2) * 2 + (x % 2 == 0);
+    }
+
+    bool isNull() const { return start == NoSquare; }
+    QPoint from() const;
+    QPoint to() const;
+    int captures() const;
+    // the captured squares, lowest first
+    FixedVector<int, GameEngine::MaxCaptures> capturedSquares() const;
+    bool operator==(const Move &other) const;
+
+    // "start end captured promotion", the move as the network protocol sends it
+    QString pack() const;
+    static bool unpack(const QString &text, Move &move);
+};
+static_assert(GameEngine::Size * GameEngine::Size / 2 <= 64, "the captured mask has a bit per dark square");
+static_assert(sizeof(Move) <= 16, "moves are passed around by value");
+
+// The start and end squares of a move, as kept by the transposition table
+// and the move ordering tables. Two different moves share them only in rare
+// ambiguous captures, the search treats those as one.
+struct MoveKey
+{
+    uint8_t from = 0xff, to = 0xff;
+
+    MoveKey() = default;
+    explicit MoveKey(const Move &move);
+    bool isNull() const;
+    bool matches(const Move &move) const;
+    bool operator==(MoveKey other) const;
+};
+
+class MoveGenerator
+{
+public:
+    // Lists live in the arena of the thread (see Arena.h), the search rewinds
+    // it after every node. MaxMoves is more than any position of a real game
+    // has, only ambiguous captures of many kings would grow a list.
+    static constexpr int MaxMoves = 128;
+    using MoveList = ArenaVector<Move>;
+
+    // legal moves of engine.whoseTurn(); they all capture the same number of
+    // pieces because the longest capture is mandatory
+    static MoveList generate(const GameEngine &engine);
+    static void generate(const GameEngine &engine, MoveList &moves);
+    // plays the move and passes the turn; the position records no changes()
+    static GameEngine play(const GameEngine &engine, const Move &move);
+    // the hop from S to E, played in before, added to move as GameEngine::move()
+    // plays it; with the first hop the move starts
+    static void addHop(const GameEngine &before, Move &move, QPoint S, QPoint E);
+    // the squares a piece passes through, from the start to the end, for the
+    // views that play a move one hop at a time
+    static FixedVector<QPoint, GameEngine::MaxCaptures + 1> hops(const GameEngine &engine, const Move &move);
+};
@@ -0,0 +1,116 @@
+#include "MoveOrdering.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+
+constexpr int TTMoveScore = 1 << 30;
+constexpr int CaptureScore = 1 << 24; // per captured piece
+constexpr int KillerScore = 1 << 22;
+constexpr int CounterScore = 1 << 21;
+constexpr int MaxHistory = 1 << 20;
+
+}
+
+double MoveOrdering::Stats::firstMoveRate() const
+{
+    return cutoffs ? double(firstMoveCutoffs) / double(cutoffs) : 0;
+}
+
+MoveOrdering::MoveOrdering()
+{
+    clear();
+}
+
+void MoveOrdering::clear()
+{
+    for (auto &ply : killers)
+        ply[0] = ply[1] = MoveKey{};
+    for (auto &side : counterMoves)
+        for (auto &from : side)
+            std::fill(std::begin(from), std::end(from), MoveKey{});
+    for (auto &side : history)
+        for (auto &from : side)
+            std::fill(std::begin(from), std::end(from), 0);
+    resetStats();
+}
+
+void MoveOrdering::age()
+{
+    for (auto &ply : killers)
+        ply[0] = ply[1] = MoveKey{};
+    for (auto &side : history)
+        for (auto &from : side)
+            for (auto &value : from)
+                value /= 2;
+}
+
+int MoveOrdering::score(const Move &move, int ply, int side, MoveKey ttMove, MoveKey counter) const
+{
+    MoveKey key(move);
+    if (key == ttMove)
+        return TTMoveScore;
+    int res = move.captures() * CaptureScore;
+    if (ply < MaxPly && (key == killers[ply][0] || key == killers[ply][1]))
+        res += KillerScore;
+    else if (key == counter)
+        res += CounterScore;
+    return res + history[side][key.from][key.to];
+}
+
+void MoveOrdering::sort(MoveGenerator::MoveList &moves, int ply, int side, MoveKey ttMove, MoveKey previous) const
+{
+    if (moves.size() < 2)
+        return;
+    MoveKey counter = previous.isNull() ? MoveKey{} : counterMoves[side][previous.from][previous.to];
+
+    // the index breaks ties, which keeps the generator's order among equals
+    // without the buffer std::stable_sort would allocate
+    ArenaVector<std::pair<int, int>> order(moves.size());
+    for (size_t i = 0; i < moves.size(); ++i)
+        order.push_back({-score(moves[i], ply, side, ttMove, counter), int(i)});
+    std::sort(order.begin(), order.end());
+
+    MoveGenerator::MoveList sorted(moves.size());
+    for (auto &entry : order)
+        sorted.push_back(std::move(moves[entry.second]));
+    moves = std::move(sorted);
+}
+
+void MoveOrdering::cutoff(const MoveGenerator::MoveList &moves, int index, int ply, int side, int depth, MoveKey previous)
+{
+    ++counters.cutoffs;
+    if (index == 0)
+        ++counters.firstMoveCutoffs;
+
+    MoveKey key(moves[index]);
+    if (ply < MaxPly && !(killers[ply][0] == key))
+    {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = key;
+    }
+    if (!previous.isNull())
+        counterMoves[side][previous.from][previous.to] = key;
+
+    // the cutoff move gains, the moves tried before it lose
+    auto update = [&](MoveKey k, int bonus) {
+        int &value = history[side][k.from][k.to];
+        // in 64 bits: |value| up to MaxHistory times a bonus overflows an int
+        value += bonus - int(int64_t(value) * std::abs(bonus) / MaxHistory);
+    };
+    int bonus = std::min(depth * depth, 400);
+    update(key, bonus * 32);
+    for (int i = 0; i < index; ++i)
+        update(MoveKey(moves[i]), -bonus * 32);
+}
+
+const MoveOrdering::Stats &MoveOrdering::stats() const
+{
+    return counters;
+}
+
+void MoveOrdering::resetStats()
+{
+    counters = Stats{};
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QtGlobal>
+#include "MoveGenerator.h"
+
+// Orders the moves of a search node: transposition table move first, then
+// longer captures, killers of the ply, the counter-move to the opponent's last
+// move and finally the history (butterfly) score.
+class MoveOrdering
+{
+public:
+    static constexpr int MaxPly = 64;
+    static constexpr int Squares = GameEngine::Size * GameEngine::Size; // the from and to squares of a MoveKey
+
+    struct Stats
+    {
+        qint64 cutoffs = 0;
+        qint64 firstMoveCutoffs = 0;
+
+        double firstMoveRate() const; // share of cutoffs produced by the first move tried
+    };
+
+    MoveOrdering();
+    void clear();  // forget everything, for a new game
+    void age();    // keep the tables but decay them, for a new search
+
+    // sorts moves in place, best candidates first
+    void sort(MoveGenerator::MoveList &moves, int ply, int side, MoveKey ttMove, MoveKey previous) const;
+    // records a beta cutoff produced by moves[index]
+    void cutoff(const MoveGenerator::MoveList &moves, int index, int ply, int side, int depth, MoveKey previous);
+
+    const Stats &stats() const;
+    void resetStats();
+
+private:
+    int score(const Move &move, int ply, int side, MoveKey ttMove, MoveKey counter) const;
+
+    MoveKey killers[MaxPly][2];
+    MoveKey counterMoves[2][Squares][Squares];
+    int history[2][Squares][Squares];
+    Stats counters;
+};
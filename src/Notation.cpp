@@ -0,0 +1,118 @@
+#include "Notation.h"
+#include <QRegExp>
+#include <QStringList>
+#include <algorithm>
+
+namespace
+{
+
+constexpr int Last = GameEngine::Size - 1;
+constexpr int PerRow = GameEngine::Size / 2;
+constexpr int Squares = GameEngine::Size * PerRow;
+
+}
+
+// the numbering has white at the bottom, the engine has black there
+int Notation::square(QPoint p)
+{
+    int x = Last - p.x(), y = Last - p.y();
+    return x * PerRow + y / 2 + 1;
+}
+
+QPoint Notation::cell(int square)
+{
+    int n = square - 1;
+    int x = n / PerRow, y = n % PerRow * 2 + (x % 2 == 0);
+    return QPoint(Last - x, Last - y);
+}
+
+bool Notation::readPosition(QString pos, GameEngine &engine)
+{
+    if (pos.size() != Squares + 1 || (pos[0] != 'W' && pos[0] != 'B'))
+        return false;
+    int turn = pos[0] == 'W' ? 1 : 0;
+    GameEngine res(turn, turn);
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+            res.board.get(i, j).setOccupier(-1);
+    for (int n = 1; n <= Squares; ++n)
+    {
+        QPoint p = cell(n);
+        auto &target = res.board.get(p.x(), p.y());
+        switch (pos[n].toLatin1())
+        {
+        case 'w': target.setOccupier(1, false); break;
+        case 'W': target.setOccupier(1, true); break;
+        case 'b': target.setOccupier(0, false); break;
+        case 'B': target.setOccupier(0, true); break;
+        case 'e': break;
+        default: return false;
+        }
+    }
+    engine = res;
+    return true;
+}
+
+QString Notation::writePosition(const GameEngine &engine)
+{
+    QString res = engine.whoseTurn() == 1 ? "W" : "B";
+    for (int n = 1; n <= Squares; ++n)
+    {
+        QPoint p = cell(n);
+        auto &target = engine.board.get(p.x(), p.y());
+        if (target.isEmpty())
+            res += 'e';
+        else if (target.occupier() == 1)
+            res += target.isKing() ? 'W' : 'w';
+        else
+            res += target.isKing() ? 'B' : 'b';
+    }
+    return res;
+}
+
+QString Notation::move(const Move &move)
+{
+    QString res = QString::number(square(move.from()));
+    if (!move.captured)
+        return res + "-" + QString::number(square(move.to()));
+    res += "x" + QString::number(square(move.to()));
+
+    vector<int> captured;
+    for (int jumped : move.capturedSquares())
+        captured.push_back(square(QPoint(jumped / GameEngine::Size, jumped % GameEngine::Size)));
+    std::sort(captured.begin(), captured.end());
+    for (int c : captured)
+        res += "x" + QString::number(c);
+    return res;
+}
+
+bool Notation::findMove(const GameEngine &engine, QString text, Move &move)
+{
+    auto wanted = text.split(QRegExp("[-x]"));
+    for (auto &candidate : MoveGenerator::generate(engine))
+    {
+        auto squares = Notation::move(candidate).split(QRegExp("[-x]"));
+        // captured squares are optional when the move is unambiguous anyway
+        if (squares.mid(0, 2) != wanted.mid(0, 2))
+            continue;
+        if (wanted.size() > 2)
+        {
+            auto a = squares.mid(2), b = wanted.mid(2);
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            if (a != b)
+                continue;
+        }
+        move = candidate;
+        return true;
+    }
+    return false;
+}
+
+QString Notation::line(const vector<Move> &moves)
+{
+    QStringList res;
+    for (auto &m : moves)
+        res << move(m);
+    return res.join(' ');
+}
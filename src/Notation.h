@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QString>
+#include "GameEngine.h"
+#include "MoveGenerator.h"
+
+// Standard notation of international draughts: the dark squares numbered
+// 1-50 row by row with white (occupier 1) at the bottom, "a-b" for a quiet
+// move and "axb" followed by "xc" for every captured square otherwise.
+// Positions are the 51 characters of the Hub protocol, the side to move
+// (W/B) followed by w/W/b/B/e for every square.
+class Notation
+{
+public:
+    static int square(QPoint p);
+    static QPoint cell(int square);
+
+    // the side to move gets the role, as the one to analyse
+    static bool readPosition(QString pos, GameEngine &engine);
+    static QString writePosition(const GameEngine &engine);
+
+    static QString move(const Move &move);
+    static bool findMove(const GameEngine &engine, QString text, Move &move);
+    // moves played one after another
+    static QString line(const vector<Move> &moves);
+};
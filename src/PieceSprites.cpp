@@ -0,0 +1,91 @@
+#include "PieceSprites.h"
+#include "Config.h"
+#include <QtMath>
+
+namespace
+{
+
+// bounds the cache when windows are resized continuously
+const int MAX_SPRITES = 256;
+
+enum Kind { Piece, King };
+
+}
+
+QHash<PieceSprites::Key, QPixmap> PieceSprites::cache;
+
+bool PieceSprites::Key::operator==(const Key &other) const
+{
+    return kind == other.kind && occupier == other.occupier && king == other.king && focused == other.focused
+        && width == other.width && height == other.height && dpr == other.dpr;
+}
+
+uint qHash(const PieceSprites::Key &key, uint seed)
+{
+    uint h = seed;
+    for (int v : {key.kind, key.occupier, key.king, key.focused, key.width, key.height, key.dpr})
+        h = h * 31 + uint(v);
+    return h;
+}
+
+QPixmap PieceSprites::piece(int occupier, bool king, bool focused, QSize cell, qreal dpr)
+{
+    Key key{Piece, occupier, king, focused, cell.width(), cell.height(), qRound(dpr * 100)};
+    auto it = cache.constFind(key);
+    if (it != cache.constEnd())
+        return *it;
+    if (cache.size() >= MAX_SPRITES)
+        cache.clear();
+    return cache[key] = render(key);
+}
+
+QPixmap PieceSprites::king(int occupier, QSize size, qreal dpr)
+{
+    Key key{King, occupier, true, false, size.width(), size.height(), qRound(dpr * 100)};
+    auto it = cache.constFind(key);
+    if (it != cache.constEnd())
+        return *it;
+    if (cache.size() >= MAX_SPRITES)
+        cache.clear();
+    return cache[key] = render(key);
+}
+
+// the crown images are decoded once, whatever the sizes they are needed at
+QPixmap &PieceSprites::source(int occupier)
+{
+    static QPixmap light(":/icons/king-light.png"), dark(":/icons/king-dark.png");
+    return occupier ? light : dark;
+}
+
+QPixmap PieceSprites::render(const Key &key)
+{
+    const qreal dpr = key.dpr / 100.0;
+    const QSize pixels(qCeil(key.width * dpr), qCeil(key.height * dpr));
+    if (key.kind == King)
+    {
+        QPixmap res = source(key.occupier).scaled(pixels, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        res.setDevicePixelRatio(dpr);
+        return res;
+    }
+
+    QPixmap res(pixels);
+    res.setDevicePixelRatio(dpr);
+    res.fill(Qt::transparent);
+
+    QPainter painter(&res);
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+
+    const int margin = 7;
+    const int stroke = 5;
+    painter.setPen(key.focused ? QPen(Config::Colors::PIECE_FOCUSED, stroke) : Qt::NoPen);
+    painter.setBrush(QBrush(key.occupier ? Config::Colors::PIECE_LIGHT : Config::Colors::PIECE_DARK));
+    painter.drawEllipse(margin, margin, key.width - margin * 2, key.height - margin * 2);
+    if (key.king)
+    {
+        const int margin = 14;
+        QSize size(key.width - margin * 2, key.height - margin * 2);
+        painter.drawPixmap(margin, margin, king(key.occupier, size, dpr));
+    }
+    return res;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QHash>
+#include <QPixmap>
+
+// Pre-rendered pieces shared by every widget that draws one. Sprites are made
+// for the exact device pixel size they are painted at (logical size times the
+// screen's device pixel ratio), so painting is a single unscaled blit; a
+// resize or a move to another screen just asks for another size, which gets
+// rendered once on first use.
+class PieceSprites
+{
+public:
+    // a piece centered in a cell of the given size, transparent around it
+    static QPixmap piece(int occupier, bool king, bool focused, QSize cell, qreal dpr);
+    // the crown alone, scaled to size
+    static QPixmap king(int occupier, QSize size, qreal dpr);
+
+private:
+    struct Key
+    {
+        int kind, occupier, king, focused, width, height, dpr;
+        bool operator==(const Key &other) const;
+    };
+    friend uint qHash(const Key &key, uint seed);
+
+    static QPixmap &source(int occupier);
+    static QPixmap render(const Key &key);
+
+    static QHash<Key, QPixmap> cache;
+};
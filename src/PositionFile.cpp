@@ -0,0 +1,118 @@
+#include "PositionFile.h"
+
+static_assert(GameEngine::Size * GameEngine::Size / 2 <= 64, "a packed position has a bit per dark square");
+
+static int squareIndex(int i, int j)
+{
+    return i * (GameEngine::Size / 2) + j / 2;
+}
+
+PackedPosition PackedPosition::pack(const GameEngine &engine, int result)
+{
+    PackedPosition res;
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+        {
+            auto &cell = engine.board.get(i, j);
+            if (!((i + j) & 1) || cell.isEmpty())
+                continue;
+            uint64_t bit = uint64_t(1) << squareIndex(i, j);
+            res.pieces[cell.occupier()] |= bit;
+            if (cell.isKing())
+                res.kings |= bit;
+        }
+    res.turn = uint8_t(engine.whoseTurn() == 1);
+    res.result = int8_t(result);
+    return res;
+}
+
+GameEngine PackedPosition::unpack() const
+{
+    // analysed from the side to move
+    GameEngine engine(turn, turn);
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+        {
+            auto &cell = engine.board.get(i, j);
+            cell.setOccupier(-1);
+            if (!((i + j) & 1))
+                continue;
+            uint64_t bit = uint64_t(1) << squareIndex(i, j);
+            for (int occupier = 0; occupier < 2; ++occupier)
+                if (pieces[occupier] & bit)
+                    cell.setOccupier(occupier, kings & bit);
+        }
+    return engine;
+}
+
+PositionFile::PositionFile(QString fileName)
+    : file(fileName)
+{
+
+}
+
+PositionFile::~PositionFile()
+{
+    close();
+}
+
+bool PositionFile::open()
+{
+    close();
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    count = file.size() / qint64(sizeof(PackedPosition));
+    if (!count)
+        return true;
+    data = reinterpret_cast<const PackedPosition *>(file.map(0, count * qint64(sizeof(PackedPosition))));
+    if (!data)
+    {
+        count = 0;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+void PositionFile::close()
+{
+    if (data)
+        file.unmap(reinterpret_cast<uchar *>(const_cast<PackedPosition *>(data)));
+    data = nullptr;
+    count = 0;
+    file.close();
+}
+
+QString PositionFile::errorString() const
+{
+    return file.errorString();
+}
+
+qint64 PositionFile::size() const
+{
+    return count;
+}
+
+const PackedPosition &PositionFile::operator[](qint64 i) const
+{
+    return data[i];
+}
+
+const PackedPosition *PositionFile::begin() const
+{
+    return data;
+}
+
+const PackedPosition *PositionFile::end() const
+{
+    return data + count;
+}
+
+bool PositionFile::write(QString fileName, const PackedPosition *positions, qint64 count, bool append)
+{
+    QFile f(fileName);
+    if (!f.open(append ? QIODevice::WriteOnly | QIODevice::Append : QIODevice::WriteOnly))
+        return false;
+    qint64 bytes = count * qint64(sizeof(PackedPosition));
+    return f.write(reinterpret_cast<const char *>(positions), bytes) == bytes;
+}
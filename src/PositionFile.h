@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <QFile>
+#include "GameEngine.h"
+
+// Fixed-size binary position record. A position file is a plain array of them,
+// so it can be memory-mapped and indexed without parsing.
+//
+// Squares are the playable cells of the engine's board numbered row by row
+// (bit i * (Size / 2) + j / 2).
+struct PackedPosition
+{
+    uint64_t pieces[2] = {0, 0}; // by occupier, kings included
+    uint64_t kings = 0;
+    uint8_t turn = 0;            // occupier to move
+    int8_t result = 0;           // for the side to move: 1 win, 0 draw, -1 loss
+    uint8_t reserved[6] = {};
+
+    static PackedPosition pack(const GameEngine &engine, int result = 0);
+    // returns an engine seen from the side to move, as the AI searches it
+    GameEngine unpack() const;
+};
+
+static_assert(sizeof(PackedPosition) == 32, "PackedPosition is part of the file format");
+
+class PositionFile
+{
+public:
+    explicit PositionFile(QString fileName);
+    ~PositionFile();
+
+    bool open(); // maps the whole file read-only
+    void close();
+    QString errorString() const;
+
+    qint64 size() const;
+    const PackedPosition &operator[](qint64 i) const;
+    const PackedPosition *begin() const;
+    const PackedPosition *end() const;
+
+    static bool write(QString fileName, const PackedPosition *positions, qint64 count, bool append = false);
+
+private:
+    QFile file;
+    const PackedPosition *data = nullptr;
+    qint64 count = 0;
+};
@@ -0,0 +1,218 @@
+#include "Profiler.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QMutex>
+#include <QStringList>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace
+{
+
+// names are kept sorted so reports are stable
+struct Registry
+{
+    QMutex mutex;
+    std::map<std::string, std::unique_ptr<Profiler::Counter>> counters;
+    std::map<std::string, std::unique_ptr<Profiler::Histogram>> histograms;
+    std::map<std::string, std::unique_ptr<Profiler::Histogram>> timers;
+};
+
+Registry &registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+template<typename T>
+T &lookup(std::map<std::string, std::unique_ptr<T>> &metrics, const char *name)
+{
+    QMutexLocker locker(&registry().mutex);
+    auto &metric = metrics[name];
+    if (!metric)
+        metric.reset(new T);
+    return *metric;
+}
+
+int bitWidth(uint64_t value)
+{
+    int width = 0;
+    while (value)
+    {
+        ++width;
+        value >>= 1;
+    }
+    return width;
+}
+
+QString formatTime(double ns)
+{
+    if (ns >= 1e6)
+        return QString::number(ns / 1e6, 'f', 2) + " ms";
+    if (ns >= 1e3)
+        return QString::number(ns / 1e3, 'f', 1) + " us";
+    return QString::number(ns, 'f', 0) + " ns";
+}
+
+}
+
+void Profiler::Histogram::record(uint64_t value)
+{
+    buckets[std::min(bitWidth(value), Buckets - 1)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+    uint64_t current = maximum.load(std::memory_order_relaxed);
+    while (value > current && !maximum.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        ;
+}
+
+int64_t Profiler::Histogram::count() const
+{
+    int64_t res = 0;
+    for (auto &bucket : buckets)
+        res += bucket.load(std::memory_order_relaxed);
+    return res;
+}
+
+uint64_t Profiler::Histogram::sum() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::Histogram::max() const
+{
+    return maximum.load(std::memory_order_relaxed);
+}
+
+uint64_t Profiler::Histogram::percentile(double p) const
+{
+    int64_t target = int64_t(p * count()), seen = 0;
+    for (int k = 0; k < Buckets; ++k)
+    {
+        seen += buckets[k].load(std::memory_order_relaxed);
+        if (seen > target)
+            return std::min(k ? (uint64_t(1) << k) - 1 : 0, max());
+    }
+    return max();
+}
+
+void Profiler::Histogram::reset()
+{
+    for (auto &bucket : buckets)
+        bucket = 0;
+    total = 0;
+    maximum = 0;
+}
+
+Profiler::Counter &Profiler::counter(const char *name)
+{
+    return lookup(registry().counters, name);
+}
+
+Profiler::Histogram &Profiler::histogram(const char *name)
+{
+    return lookup(registry().histograms, name);
+}
+
+Profiler::Histogram &Profiler::timer(const char *name)
+{
+    return lookup(registry().timers, name);
+}
+
+bool Profiler::isEnabled()
+{
+#ifdef DRAUGHTS_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Profiler::reset()
+{
+    auto &r = registry();
+    QMutexLocker locker(&r.mutex);
+    for (auto &metric : r.counters)
+        metric.second->reset();
+    for (auto &metric : r.histograms)
+        metric.second->reset();
+    for (auto &metric : r.timers)
+        metric.second->reset();
+}
+
+QString Profiler::report()
+{
+    if (!isEnabled())
+        return "Profiling is not compiled in (build with CONFIG+=profile).";
+
+    auto row = [](QString name, QStringList columns) {
+        QString res = name.leftJustified(28);
+        for (auto &column : columns)
+            res += column.rightJustified(10);
+        return res + "\n";
+    };
+
+    auto &r = registry();
+    QMutexLocker locker(&r.mutex);
+    QString res = row("", {"calls", "mean", "p50", "p99", "max"});
+    for (auto &metric : r.timers)
+    {
+        auto &h = *metric.second;
+        if (h.count())
+            res += row(QString::fromStdString(metric.first),
+                       {QString::number(h.count()), formatTime(double(h.sum()) / h.count()),
+                        formatTime(h.percentile(0.5)), formatTime(h.percentile(0.99)), formatTime(h.max())});
+    }
+    for (auto &metric : r.histograms)
+    {
+        auto &h = *metric.second;
+        if (h.count())
+            res += row(QString::fromStdString(metric.first),
+                       {QString::number(h.count()), QString::number(double(h.sum()) / h.count(), 'f', 1),
+                        QString::number(h.percentile(0.5)), QString::number(h.percentile(0.99)), QString::number(h.max())});
+    }
+    for (auto &metric : r.counters)
+        res += row(QString::fromStdString(metric.first), {QString::number(metric.second->get())});
+    return res;
+}
+
+QJsonObject Profiler::toJson()
+{
+    auto &r = registry();
+    QMutexLocker locker(&r.mutex);
+    auto histogramJson = [](const Histogram &h) {
+        QJsonObject res;
+        res["count"] = double(h.count());
+        res["sum"] = double(h.sum());
+        res["max"] = double(h.max());
+        res["p50"] = double(h.percentile(0.5));
+        res["p90"] = double(h.percentile(0.9));
+        res["p99"] = double(h.percentile(0.99));
+        return res;
+    };
+
+    QJsonObject timers, histograms, counters;
+    for (auto &metric : r.timers)
+        timers[QString::fromStdString(metric.first)] = histogramJson(*metric.second);
+    for (auto &metric : r.histograms)
+        histograms[QString::fromStdString(metric.first)] = histogramJson(*metric.second);
+    for (auto &metric : r.counters)
+        counters[QString::fromStdString(metric.first)] = double(metric.second->get());
+
+    QJsonObject res;
+    res["enabled"] = isEnabled();
+    res["timers_ns"] = timers;
+    res["histograms"] = histograms;
+    res["counters"] = counters;
+    return res;
+}
+
+bool Profiler::dump(QString fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return false;
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    return true;
+}
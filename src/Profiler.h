@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <QJsonObject>
+#include <QString>
+
+// Counters, histograms and scoped timers for finding where time goes.
+//
+// Instrumentation is written with the PROFILE_* macros, which compile to
+// nothing unless the build defines DRAUGHTS_PROFILE (qmake CONFIG+=profile),
+// so release builds pay nothing for them. Enabled, a probe costs a clock read
+// and a couple of relaxed atomic increments; metrics are registered once per
+// call site and may be updated from any thread.
+//
+//     PROFILE_SCOPE("engine.updateMovable");  // time until the end of the scope
+//     PROFILE_COUNT("net.bytesSent", n);
+//     PROFILE_VALUE("paint.squares", count);  // distribution of a quantity
+class Profiler
+{
+public:
+    class Counter
+    {
+    public:
+        void add(int64_t n) { value.fetch_add(n, std::memory_order_relaxed); }
+        int64_t get() const { return value.load(std::memory_order_relaxed); }
+        void reset() { value = 0; }
+
+    private:
+        std::atomic<int64_t> value{0};
+    };
+
+    // power of two buckets, bucket k holding values of bit width k
+    class Histogram
+    {
+    public:
+        static constexpr int Buckets = 64;
+
+        void record(uint64_t value);
+        int64_t count() const;
+        uint64_t sum() const;
+        uint64_t max() const;
+        uint64_t percentile(double p) const; // upper bound of the bucket holding it
+        void reset();
+
+    private:
+        std::atomic<int64_t> buckets[Buckets] = {};
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> maximum{0};
+    };
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Histogram &histogram)
+            : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer()
+        {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            histogram.record(uint64_t(ns.count()));
+        }
+
+    private:
+        Histogram &histogram;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // references stay valid for the whole run
+    static Counter &counter(const char *name);
+    static Histogram &histogram(const char *name);
+    static Histogram &timer(const char *name); // a histogram of nanoseconds
+
+    static bool isEnabled();
+    static void reset();
+    static QString report();   // a table for humans
+    static QJsonObject toJson();
+    static bool dump(QString fileName);
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef DRAUGHTS_PROFILE
+#define PROFILE_SCOPE(name) \
+    static Profiler::Histogram &PROFILE_CONCAT(profileTimer_, __LINE__) = Profiler::timer(name); \
+    Profiler::ScopedTimer PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileTimer_, __LINE__))
+#define PROFILE_COUNT(name, n) \
+    do { static Profiler::Counter &counter = Profiler::counter(name); counter.add(n); } while (0)
+#define PROFILE_VALUE(name, value) \
+    do { static Profiler::Histogram &histogram = Profiler::histogram(name); histogram.record(value); } while (0)
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_COUNT(name, n) do { (void)sizeof(n); } while (0)
+#define PROFILE_VALUE(name, value) do { (void)sizeof(value); } while (0)
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+
+// The finalizer of splitmix64, spreading any 64-bit value over all the bits.
+inline uint64_t mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// splitmix64, small and good enough for hash keys and to pick moves; not for
+// anything that has to be unpredictable
+inline uint64_t splitmix64(uint64_t &state)
+{
+    return mix64(state += 0x9e3779b97f4a7c15ull);
+}
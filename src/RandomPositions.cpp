@@ -0,0 +1,61 @@
+#include "RandomPositions.h"
+#include "GeneratorCheck.h"
+#include "Random.h"
+
+namespace
+{
+
+using Position = GeneratorCheck::Position;
+
+}
+
+RandomPositions::RandomPositions(const Settings &settings)
+    : config(settings)
+{
+
+}
+
+const RandomPositions::Settings &RandomPositions::settings() const
+{
+    return config;
+}
+
+bool RandomPositions::generate(uint64_t index, PackedPosition &result) const
+{
+    uint64_t state = config.seed;
+    state = splitmix64(state) ^ index;
+    for (int attempt = 0; attempt < Attempts; ++attempt)
+    {
+        int target = config.maxPieces;
+        if (config.maxPieces > config.minPieces)
+            target = config.minPieces + int(splitmix64(state) % uint64_t(config.maxPieces - config.minPieces + 1));
+
+        auto position = Position::initial();
+        for (int ply = 0; ply < MaxPlies; ++ply)
+        {
+            auto moves = position.generate();
+            if (moves.empty())
+                break;
+
+            int pieces = 0, kings = 0;
+            for (int square = 0; square < Position::Squares; ++square)
+            {
+                uint8_t piece = position.piece(square);
+                pieces += piece != Position::Empty;
+                kings += (piece & Position::King) != 0;
+            }
+            if (pieces < config.minPieces)
+                break;
+            double share = double(kings) / pieces;
+            if (share > config.maxKings)
+                break;
+            if (pieces <= target && share >= config.minKings && !(config.quiet && !moves.front().captured.empty()))
+            {
+                result = PackedPosition::pack(GeneratorCheck::toEngine(position));
+                return true;
+            }
+            position.play(moves[splitmix64(state) % moves.size()]);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include "PositionFile.h"
+
+// Random positions reachable from the initial one, for tests, tuning and
+// benchmarks. Each comes from random playouts of its own, seeded from the
+// seed and its index, so position i is the same whatever order or thread it
+// is generated in. Playouts use the VariantPosition generator of the rules
+// GameEngine plays, which is the fastest one.
+//
+// A playout picks a number of pieces between the bounds and plays random
+// moves until the board has no more than that, with a share of kings within
+// the bounds (and nothing to capture when quiet is set). Playouts that lose
+// too many pieces or reach too many kings on the way are played again.
+class RandomPositions
+{
+public:
+    struct Settings
+    {
+        uint64_t seed = 1;
+        int minPieces = 2, maxPieces = 40; // both sides together
+        double minKings = 0, maxKings = 1; // share of the pieces
+        bool quiet = false;                // the side to move has no capture
+    };
+
+    static constexpr int Attempts = 256;
+    static constexpr int MaxPlies = 400;
+
+    explicit RandomPositions(const Settings &settings);
+
+    // false when no playout met the settings within the attempts
+    bool generate(uint64_t index, PackedPosition &result) const;
+    const Settings &settings() const;
+
+private:
+    Settings config;
+};
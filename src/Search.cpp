@@ -0,0 +1,344 @@
+#include "Search.h"
+#include "GameEngine.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace
+{
+
+// mate scores are stored relative to the node, not to the root
+int toTT(int score, int ply)
+{
+    if (score > Search::MateBound)
+        return score + ply;
+    if (score < -Search::MateBound)
+        return score - ply;
+    return score;
+}
+
+int fromTT(int score, int ply)
+{
+    if (score > Search::MateBound)
+        return score - ply;
+    if (score < -Search::MateBound)
+        return score + ply;
+    return score;
+}
+
+}
+
+Search::Search(const Evaluation &evaluation, int hashMegabytes)
+    : evaluation(evaluation), tt(hashMegabytes)
+{
+
+}
+
+quint64 Search::ticket()
+{
+    return ++tickets;
+}
+
+void Search::stop()
+{
+    quint64 last = tickets.load(), current = cancelled.load();
+    while (current < last && !cancelled.compare_exchange_weak(current, last))
+        ;
+    stopped = true;
+}
+
+void Search::ponderHit(quint64 ticket, const Limits &limits)
+{
+    std::lock_guard<std::mutex> locker(ponderMutex);
+    ponderLimits = limits;
+    ponderTicket = ticket;
+}
+
+void Search::newGame()
+{
+    tt.clear();
+    ordering.clear();
+}
+
+void Search::setHashSize(int megabytes)
+{
+    tt.resize(megabytes);
+}
+
+void Search::startClock()
+{
+    if (limits.moveTime)
+        timeManager.startFixed(limits.moveTime);
+    else if (limits.time)
+        timeManager.start(limits.time, limits.increment, limits.movesToGo);
+    else
+        timeManager.startInfinite();
+}
+
+bool Search::shouldStop()
+{
+    if (cancelled.load(std::memory_order_relaxed) >= running)
+        stopped = true;
+    if (ponderTicket.load(std::memory_order_relaxed) == running)
+    {
+        std::lock_guard<std::mutex> locker(ponderMutex);
+        ponderTicket = 0;
+        int multiPV = limits.multiPV;
+        limits = ponderLimits;
+        limits.multiPV = multiPV;
+        startClock();
+    }
+    if (limits.nodes && nodes + qnodes >= limits.nodes)
+        stopped = true;
+    if (((nodes + qnodes) & 1023) == 0)
+    {
+        published.store(nodes + qnodes, std::memory_order_relaxed);
+        if (timeManager.isHardLimitReached())
+            stopped = true;
+    }
+    return stopped;
+}
+
+void Search::setInfoCallback(std::function<void(const Result &)> callback)
+{
+    infoCallback = std::move(callback);
+}
+
+qint64 Search::progress() const
+{
+    return published.load(std::memory_order_relaxed);
+}
+
+// follows the transposition table from the position after the first move
+vector<Move> Search::principalVariation(const GameEngine &root, const Move &first, int length)
+{
+    vector<Move> pv;
+    pv.push_back(first);
+    auto engine = MoveGenerator::play(root, first);
+    while (int(pv.size()) < length)
+    {
+        auto entry = tt.probe(TranspositionTable::hash(engine));
+        if (!entry || entry->move.isNull())
+            break;
+        auto moves = MoveGenerator::generate(engine);
+        auto it = std::find_if(moves.begin(), moves.end(), [&](const Move &move) {
+            return entry->move.matches(move);
+        });
+        if (it == moves.end())
+            break;
+        pv.push_back(*it);
+        engine = MoveGenerator::play(engine, *it);
+    }
+    return pv;
+}
+
+// a position repeated on the way to it counts as a draw already, as the
+// side that could avoid it would do so at the first repetition
+bool Search::isDraw() const
+{
+    return history.repetitions() >= 2 || history.draw() != GameHistory::None;
+}
+
+Search::Result Search::run(const GameEngine &root, const Limits &limits, const GameHistory &history, quint64 ticket)
+{
+    PROFILE_SCOPE("search.run");
+    this->limits = limits;
+    startClock();
+    this->history = history;
+    if (this->history.isEmpty())
+        this->history.reset(root);
+    this->history.reserve(MoveOrdering::MaxPly + 1);
+    nodes = qnodes = 0;
+    published = 0;
+    running = ticket ? ticket : this->ticket();
+    stopped = cancelled.load() >= running;
+    ordering.age();
+    ordering.resetStats();
+
+    // move lists of the nodes live in the arena, see MoveGenerator::MoveList;
+    // the only heap allocations left are per iteration
+    Arena::Scope scope;
+    Result result;
+    auto moves = MoveGenerator::generate(root);
+    if (moves.empty())
+    {
+        result.score = -Mate;
+        return result;
+    }
+    result.best = moves.front();
+    // nothing to think about when playing on a clock
+    if (moves.size() == 1 && (limits.time || limits.moveTime))
+        return result;
+
+    int side = root.whoseTurn();
+    auto key = TranspositionTable::hash(root);
+    ordering.sort(moves, 0, side, MoveKey{}, MoveKey{});
+
+    struct RootMove
+    {
+        Move move;
+        int score;
+    };
+    vector<RootMove> rootMoves;
+    for (auto &move : moves)
+        rootMoves.push_back(RootMove{move, -Infinity});
+    int multiPV = std::max(1, std::min<int>(limits.multiPV, int(rootMoves.size())));
+
+    for (int depth = 1; depth <= std::min(this->limits.depth, MoveOrdering::MaxPly - 1); ++depth)
+    {
+        Arena::Scope iteration;
+        // every move is searched against the multiPV-th best score so far, so
+        // the best multiPV moves get exact scores and the others upper bounds
+        SmallVector<int, 8> bestScores;
+        int searched = 0;
+        for (auto &rootMove : rootMoves)
+        {
+            int alpha = int(bestScores.size()) < multiPV ? -Infinity : bestScores.back();
+            auto child = MoveGenerator::play(root, rootMove.move);
+            this->history.push(root, rootMove.move);
+            int score = -alphaBeta(child, depth - 1, 1, -Infinity, -alpha, MoveKey(rootMove.move));
+            this->history.pop();
+            if (stopped)
+                break;
+            rootMove.score = score;
+            ++searched;
+            bestScores.insert(std::upper_bound(bestScores.begin(), bestScores.end(), score, std::greater<int>()), score);
+            if (int(bestScores.size()) > multiPV)
+                bestScores.pop_back();
+        }
+        // a partial iteration is only trusted for the moves it finished,
+        // the previous best move is always among them
+        if (!searched)
+            break;
+        std::stable_sort(rootMoves.begin(), rootMoves.begin() + searched, [](const RootMove &a, const RootMove &b) {
+            return a.score > b.score;
+        });
+
+        auto &best = rootMoves.front();
+        if (depth > 1 && !(best.move == result.best))
+            timeManager.bestMoveChanged();
+        result.best = best.move;
+        result.score = best.score;
+        result.depth = depth;
+        tt.store(key, depth, toTT(best.score, 0), TranspositionTable::Exact, MoveKey(best.move));
+
+        result.lines.clear();
+        for (int i = 0; i < std::min(multiPV, searched); ++i)
+            result.lines.push_back(Line{rootMoves[i].score, principalVariation(root, rootMoves[i].move, depth)});
+        result.nodes = nodes;
+        result.qnodes = qnodes;
+        result.time = timeManager.elapsed();
+        if (infoCallback)
+            infoCallback(result);
+
+        if (stopped || best.score > MateBound || best.score < -MateBound || !timeManager.canStartIteration())
+            break;
+    }
+
+    result.nodes = nodes;
+    result.qnodes = qnodes;
+    result.time = timeManager.elapsed();
+    result.ordering = ordering.stats();
+    PROFILE_COUNT("search.nodes", nodes);
+    PROFILE_COUNT("search.qnodes", qnodes);
+    return result;
+}
+
+int Search::alphaBeta(const GameEngine &engine, int depth, int ply, int alpha, int beta, MoveKey previous)
+{
+    if (isDraw())
+        return 0;
+    if (depth <= 0)
+        return quiescence(engine, ply, alpha, beta);
+
+    ++nodes;
+    if (shouldStop())
+        return 0;
+    if (ply >= MoveOrdering::MaxPly)
+        return evaluation(engine);
+
+    auto key = TranspositionTable::hash(engine);
+    MoveKey ttMove;
+    if (auto entry = tt.probe(key))
+    {
+        ttMove = entry->move;
+        if (entry->depth >= depth)
+        {
+            int score = fromTT(entry->score, ply);
+            if (entry->bound == TranspositionTable::Exact ||
+                (entry->bound == TranspositionTable::Lower && score >= beta) ||
+                (entry->bound == TranspositionTable::Upper && score <= alpha))
+                return score;
+        }
+    }
+
+    Arena::Scope scope;
+    auto moves = MoveGenerator::generate(engine);
+    if (moves.empty())
+        return -Mate + ply;
+
+    int side = engine.whoseTurn();
+    ordering.sort(moves, ply, side, ttMove, previous);
+
+    int originalAlpha = alpha;
+    int best = -Infinity;
+    MoveKey bestMove;
+    for (int i = 0; i < int(moves.size()); ++i)
+    {
+        auto child = MoveGenerator::play(engine, moves[i]);
+        history.push(engine, moves[i]);
+        int score = -alphaBeta(child, depth - 1, ply + 1, -beta, -alpha, MoveKey(moves[i]));
+        history.pop();
+        if (stopped)
+            return 0;
+        if (score > best)
+        {
+            best = score;
+            bestMove = MoveKey(moves[i]);
+        }
+        if (score > alpha)
+            alpha = score;
+        if (alpha >= beta)
+        {
+            ordering.cutoff(moves, i, ply, side, depth, previous);
+            break;
+        }
+    }
+
+    auto bound = best >= beta ? TranspositionTable::Lower
+               : best > originalAlpha ? TranspositionTable::Exact
+               : TranspositionTable::Upper;
+    tt.store(key, depth, toTT(best, ply), bound, bestMove);
+    return best;
+}
+
+// Captures are mandatory, so a leaf where the side to move has to capture is
+// not quiet: keep searching until nobody has to. There is no stand-pat, the
+// side to move can't decline a capture.
+int Search::quiescence(const GameEngine &engine, int ply, int alpha, int beta)
+{
+    ++qnodes;
+    if (shouldStop())
+        return 0;
+    if (ply >= MoveOrdering::MaxPly)
+        return evaluation(engine);
+
+    Arena::Scope scope;
+    auto moves = MoveGenerator::generate(engine);
+    if (moves.empty())
+        return -Mate + ply;
+    if (!moves.front().captures())
+        return evaluation(engine);
+
+    int best = -Infinity;
+    for (auto &move : moves)
+    {
+        int score = -quiescence(MoveGenerator::play(engine, move), ply + 1, -beta, -alpha);
+        if (stopped)
+            return 0;
+        best = std::max(best, score);
+        alpha = std::max(alpha, score);
+        if (alpha >= beta)
+            break;
+    }
+    return best;
+}
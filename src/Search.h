@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <QtGlobal>
+#include "Evaluation.h"
+#include "GameHistory.h"
+#include "MoveGenerator.h"
+#include "MoveOrdering.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+
+class GameEngine;
+
+// Iterative deepening alpha-beta search for engine.whoseTurn().
+class Search
+{
+public:
+    static constexpr int Infinity = 30000;
+    static constexpr int Mate = 20000;
+    static constexpr int MateBound = Mate - MoveOrdering::MaxPly;
+
+    struct Limits
+    {
+        int depth = 6;
+        qint64 nodes = 0;    // 0 for unlimited
+        qint64 time = 0;     // ms left on the clock, 0 for no clock
+        qint64 increment = 0;
+        int movesToGo = 0;   // 0 if unknown
+        qint64 moveTime = 0; // fixed time for this move, overrides the clock
+        int multiPV = 1;     // number of best root moves searched with exact scores
+    };
+
+    struct Line
+    {
+        int score = 0;
+        vector<Move> pv; // from the root on
+    };
+
+    struct Result
+    {
+        Move best;     // empty path if there is no legal move
+        int score = 0;
+        int depth = 0;
+        vector<Line> lines; // best first, up to Limits::multiPV of them
+        qint64 nodes = 0;
+        qint64 qnodes = 0; // nodes of the quiescence search, not part of nodes
+        qint64 time = 0; // ms
+        MoveOrdering::Stats ordering;
+    };
+
+    explicit Search(const Evaluation &evaluation = Evaluation(), int hashMegabytes = 16);
+
+    // history is the game up to and including root, for the draw rules;
+    // without one the search only knows about its own lines. A search queued
+    // on another thread takes its ticket() before: a stop() in between then
+    // stops it as soon as it starts, instead of being lost
+    Result run(const GameEngine &root, const Limits &limits, const GameHistory &history = GameHistory(),
+               quint64 ticket = 0);
+    quint64 ticket();
+    void stop(); // stops the running search and every ticket taken; may be called from any thread
+    // puts the search of ticket, started without limits to ponder, on the
+    // clock of limits from now on; may be called from any thread
+    void ponderHit(quint64 ticket, const Limits &limits);
+    void newGame();
+    void setHashSize(int megabytes);
+
+    // called from the searching thread after every completed iteration
+    void setInfoCallback(std::function<void(const Result &)> callback);
+    // nodes searched so far by the running search, safe to read from any thread
+    qint64 progress() const;
+
+private:
+    int alphaBeta(const GameEngine &engine, int depth, int ply, int alpha, int beta, MoveKey previous);
+    int quiescence(const GameEngine &engine, int ply, int alpha, int beta);
+    bool shouldStop();
+    void startClock();
+    bool isDraw() const;
+    vector<Move> principalVariation(const GameEngine &root, const Move &first, int length);
+
+    Evaluation evaluation;
+    TranspositionTable tt;
+    MoveOrdering ordering;
+    Limits limits;
+    TimeManager timeManager;
+    GameHistory history;
+    qint64 nodes = 0, qnodes = 0;
+    std::atomic<bool> stopped{false};
+    std::atomic<quint64> tickets{0}, cancelled{0}; // the last ticket taken, the last one stopped
+    quint64 running = 0; // ticket of the current run
+    std::mutex ponderMutex; // guards ponderLimits
+    Limits ponderLimits;
+    std::atomic<quint64> ponderTicket{0}; // the run to put on ponderLimits
+    std::atomic<qint64> published{0};
+    std::function<void(const Result &)> infoCallback;
+};
@@ -19,12 +19,13 @@
 **********************************************************************/ 
 
 #include "Server.h"
+#include "Logger.h"
 
 Server::Server(QString ip, int port)
 {
     listenSocket = new QTcpServer;
     listenSocket->listen(QHostAddress(ip), port);
-    qInfo("Server is listening at %s:%d...", ip.toStdString().c_str(), port);
+    qCInfo(lcNet, "Server is listening at %s:%d...", ip.toStdString().c_str(), port);
     connect(listenSocket, &QTcpServer::newConnection, this, &Server::acceptConnection);
 }
 
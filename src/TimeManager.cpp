@@ -0,0 +1,82 @@
+#include "TimeManager.h"
+#include <algorithm>
+
+namespace
+{
+
+constexpr int DefaultMovesToGo = 25;
+constexpr qint64 Overhead = 50;  // ms lost between the search and the clock
+constexpr qint64 MinimumTime = 10;
+
+}
+
+bool TimeControl::isEnabled() const
+{
+    return base > 0;
+}
+
+void TimeManager::start(qint64 remaining, qint64 increment, int movesToGo)
+{
+    timer.start();
+    limited = true;
+    if (movesToGo <= 0)
+        movesToGo = DefaultMovesToGo;
+
+    qint64 available = std::max<qint64>(remaining - Overhead, 0);
+    soft = available / movesToGo + increment * 3 / 4;
+    soft = std::min(soft, available * 2 / 5);
+    hard = std::min(soft * 4, available / 2);
+    soft = std::max(soft, MinimumTime);
+    hard = std::max(hard, soft);
+    maximum = std::max(soft, hard / 2);
+}
+
+void TimeManager::startFixed(qint64 moveTime)
+{
+    timer.start();
+    limited = true;
+    soft = hard = maximum = std::max(moveTime - Overhead, MinimumTime);
+}
+
+void TimeManager::startInfinite()
+{
+    timer.start();
+    limited = false;
+    soft = hard = maximum = 0;
+}
+
+qint64 TimeManager::elapsed() const
+{
+    return timer.elapsed();
+}
+
+qint64 TimeManager::softLimit() const
+{
+    return soft;
+}
+
+qint64 TimeManager::hardLimit() const
+{
+    return hard;
+}
+
+bool TimeManager::canStartIteration() const
+{
+    // the next iteration usually takes longer than all previous ones together
+    return !limited || elapsed() < soft / 2;
+}
+
+bool TimeManager::isSoftLimitReached() const
+{
+    return limited && elapsed() >= soft;
+}
+
+bool TimeManager::isHardLimitReached() const
+{
+    return limited && elapsed() >= hard;
+}
+
+void TimeManager::bestMoveChanged()
+{
+    soft = std::min(soft * 3 / 2, maximum);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QElapsedTimer>
+
+struct TimeControl
+{
+    qint64 base = 0;      // ms per player, 0 for no clock
+    qint64 increment = 0; // ms added after each move
+
+    bool isEnabled() const;
+};
+
+// Turns the clock of the side to move into budgets for one search. The soft
+// limit decides whether another iteration is started, the hard limit stops a
+// running one.
+class TimeManager
+{
+public:
+    void start(qint64 remaining, qint64 increment, int movesToGo = 0);
+    void startFixed(qint64 moveTime);
+    void startInfinite();
+
+    qint64 elapsed() const;
+    qint64 softLimit() const;
+    qint64 hardLimit() const;
+
+    bool canStartIteration() const;
+    // for searches made of many short steps, which stop at the soft limit
+    bool isSoftLimitReached() const;
+    bool isHardLimitReached() const;
+    // the best move changed between iterations: the position is unclear, think longer
+    void bestMoveChanged();
+
+private:
+    QElapsedTimer timer;
+    bool limited = false;
+    qint64 soft = 0, hard = 0, maximum = 0;
+};
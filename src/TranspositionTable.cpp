@@ -0,0 +1,80 @@
+#include "TranspositionTable.h"
+#include "GameEngine.h"
+#include "Random.h"
+#include <array>
+
+namespace
+{
+
+// cell * 4 + occupier * 2 + king, then one key for the side to move
+using Keys = std::array<uint64_t, GameEngine::Size * GameEngine::Size * 4 + 1>;
+
+Keys makeKeys()
+{
+    Keys keys;
+    uint64_t seed = 0x9e3779b97f4a7c15ull;
+    for (auto &key : keys)
+    {
+        key = splitmix64(seed);
+    }
+    return keys;
+}
+
+const Keys keys = makeKeys();
+
+}
+
+TranspositionTable::TranspositionTable(int megabytes)
+{
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(int megabytes)
+{
+    size_t count = 1;
+    while (count * 2 * sizeof(Entry) <= size_t(megabytes) << 20)
+        count *= 2;
+    table.assign(count, Entry{});
+    mask = count - 1;
+}
+
+void TranspositionTable::clear()
+{
+    std::fill(table.begin(), table.end(), Entry{});
+}
+
+const TranspositionTable::Entry *TranspositionTable::probe(uint64_t key) const
+{
+    auto &entry = table[key & mask];
+    return entry.key == key && entry.bound != None ? &entry : nullptr;
+}
+
+void TranspositionTable::store(uint64_t key, int depth, int score, Bound bound, MoveKey move)
+{
+    auto &entry = table[key & mask];
+    if (entry.key == key)
+    {
+        if (depth < entry.depth && entry.bound != None)
+            return;
+        if (move.isNull())
+            move = entry.move;
+    }
+    entry.key = key;
+    entry.score = int16_t(score);
+    entry.depth = int8_t(depth);
+    entry.bound = bound;
+    entry.move = move;
+}
+
+uint64_t TranspositionTable::hash(const GameEngine &engine)
+{
+    uint64_t res = engine.whoseTurn() == 1 ? keys.back() : 0;
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+        {
+            auto &cell = engine.board.get(i, j);
+            if (!cell.isEmpty())
+                res ^= keys[(i * GameEngine::Size + j) * 4 + cell.occupier() * 2 + cell.isKing()];
+        }
+    return res;
+}
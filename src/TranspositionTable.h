@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "MoveGenerator.h"
+
+class GameEngine;
+
+class TranspositionTable
+{
+public:
+    enum Bound : uint8_t
+    {
+        None, Lower, Upper, Exact
+    };
+
+    struct Entry
+    {
+        uint64_t key = 0;
+        int16_t score = 0;
+        int8_t depth = -1;
+        uint8_t bound = None;
+        MoveKey move;
+    };
+
+    explicit TranspositionTable(int megabytes = 16);
+    void resize(int megabytes);
+    void clear();
+
+    const Entry *probe(uint64_t key) const;
+    void store(uint64_t key, int depth, int score, Bound bound, MoveKey move);
+
+    // Zobrist hash of the position and the side to move
+    static uint64_t hash(const GameEngine &engine);
+
+private:
+    std::vector<Entry> table;
+    uint64_t mask = 0;
+};
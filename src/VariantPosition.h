@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <utility>
+#include "Geometry.h"
+#include "Variants.h"
+#include "utils/SmallVector.h"
+
+// A position of one of the variants in Variants.h with its move generator.
+// Everything the rules decide is a template parameter: the side to move and
+// the kind of piece are dispatched once per piece, the four directions are
+// unrolled and no test of the rules is left at run time.
+//
+// Unlike GameEngine the board has one orientation: side 0, the side moving
+// first, starts on the high rows and moves towards row 0. A move is the whole
+// capture sequence.
+template<class Rules>
+class VariantPosition
+{
+public:
+    static constexpr int Size = Rules::Size;
+    static constexpr int Squares = Size * Size;
+
+    enum Piece : uint8_t
+    {
+        Empty = 0,
+        Man = 1,
+        King = 2,
+        Side1 = 4 // the flag of side 1, white like occupier 1 of GameEngine
+    };
+
+    struct Move
+    {
+        uint8_t from = 0, to = 0;
+        bool promotion = false;
+        SmallVector<uint8_t, 8> captured; // in the order they are taken
+    };
+    using MoveList = SmallVector<Move, 32>;
+
+    static VariantPosition initial();
+
+    int sideToMove() const { return side; }
+    void setSideToMove(int side) { this->side = side; }
+    uint8_t piece(int square) const { return squares[square]; }
+    void setPiece(int square, uint8_t piece) { squares[square] = piece; }
+
+    MoveList generate() const;
+    void play(const Move &move);
+    uint64_t perft(int depth) const;
+
+private:
+    static constexpr auto &tables = Geometry::tables<Size>;
+
+    struct Capture
+    {
+        int from = 0;
+        bool promoted = false; // on the way, see Rules::PromoteDuringCapture
+        std::bitset<Squares> taken;
+        SmallVector<uint8_t, 8> captured;
+        int best = 0; // the most pieces a sequence takes, for Rules::MajorityCapture
+    };
+
+    template<int Side>
+    static constexpr bool isForward(int k) { return Side == 0 ? Geometry::dx[k] < 0 : Geometry::dx[k] > 0; }
+    template<int Side>
+    static constexpr bool isLastRow(int square) { return square / Size == (Side == 0 ? 0 : Size - 1); }
+
+    template<class F, std::size_t... K>
+    static void unroll(F &&f, std::index_sequence<K...>) { (f(std::integral_constant<int, K>{}), ...); }
+    template<class F>
+    static void forEachDirection(F &&f) { unroll(f, std::make_index_sequence<Geometry::Directions>{}); }
+
+    template<int Side>
+    bool isOwn(int square) const { return squares[square] && (squares[square] & Side1) == (Side ? Side1 : 0); }
+    template<int Side>
+    bool isEnemy(int square) const { return squares[square] && (squares[square] & Side1) != (Side ? Side1 : 0); }
+    // the moving piece has left its square
+    bool isFree(int square, const Capture &state) const { return !squares[square] || square == state.from; }
+
+    template<int Side>
+    void generate(MoveList &moves) const;
+    template<int Side, bool IsKing>
+    void capture(Capture &state, int square, MoveList &moves) const;
+    template<int Side, bool IsKing>
+    void finish(Capture &state, int square, MoveList &moves) const;
+    template<int Side, bool IsKing>
+    void quiet(int square, MoveList &moves) const;
+
+    std::array<uint8_t, Squares> squares{};
+    int side = 0;
+};
+
+template<class Rules>
+VariantPosition<Rules> VariantPosition<Rules>::initial()
+{
+    VariantPosition position;
+    for (int x = 0; x < Size; ++x)
+        for (int y = 0; y < Size; ++y)
+            if ((x + y) & 1)
+            {
+                if (x < Rules::Rows)
+                    position.squares[x * Size + y] = Man | Side1;
+                else if (x >= Size - Rules::Rows)
+                    position.squares[x * Size + y] = Man;
+            }
+    return position;
+}
+
+template<class Rules>
+typename VariantPosition<Rules>::MoveList VariantPosition<Rules>::generate() const
+{
+    MoveList moves;
+    if (side == 0)
+        generate<0>(moves);
+    else
+        generate<1>(moves);
+    return moves;
+}
+
+template<class Rules>
+template<int Side>
+void VariantPosition<Rules>::generate(MoveList &moves) const
+{
+    // captures are mandatory
+    Capture state;
+    for (int square = 0; square < Squares; ++square)
+        if (isOwn<Side>(square))
+        {
+            state.from = square;
+            if (squares[square] & King)
+                capture<Side, true>(state, square, moves);
+            else
+                capture<Side, false>(state, square, moves);
+        }
+    if (!moves.empty())
+        return;
+
+    for (int square = 0; square < Squares; ++square)
+        if (isOwn<Side>(square))
+        {
+            if (squares[square] & King)
+                quiet<Side, true>(square, moves);
+            else
+                quiet<Side, false>(square, moves);
+        }
+}
+
+// Taken pieces stay on the board until the move is over: they can't be taken
+// twice and nothing jumps over them.
+template<class Rules>
+template<int Side, bool IsKing>
+void VariantPosition<Rules>::capture(Capture &state, int square, MoveList &moves) const
+{
+    constexpr bool flying = IsKing && Rules::FlyingKings;
+    bool extended = false;
+    forEachDirection([&](auto direction) {
+        constexpr int k = decltype(direction)::value;
+        if constexpr (!IsKing && !Rules::MenCaptureBackward && !isForward<Side>(k))
+            return;
+
+        auto &ray = tables.rays[square][k];
+        int step = 0;
+        if constexpr (flying)
+            while (step < ray.length && isFree(ray.squares[step], state))
+                ++step;
+        if (step + 1 >= ray.length)
+            return;
+        int victim = ray.squares[step];
+        if (!isEnemy<Side>(victim) || state.taken.test(victim))
+            return;
+
+        for (int next = step + 1; next < ray.length && isFree(ray.squares[next], state); ++next)
+        {
+            int landing = ray.squares[next];
+            extended = true;
+            state.taken.set(victim);
+            state.captured.push_back(uint8_t(victim));
+            if constexpr (!IsKing && Rules::PromoteDuringCapture)
+            {
+                if (isLastRow<Side>(landing))
+                {
+                    state.promoted = true;
+                    capture<Side, true>(state, landing, moves);
+                    state.promoted = false;
+                }
+                else
+                    capture<Side, false>(state, landing, moves);
+            }
+            else
+                capture<Side, IsKing>(state, landing, moves);
+            state.captured.pop_back();
+            state.taken.reset(victim);
+            if constexpr (!flying)
+                break;
+        }
+    });
+    if (!extended && !state.captured.empty())
+        finish<Side, IsKing>(state, square, moves);
+}
+
+template<class Rules>
+template<int Side, bool IsKing>
+void VariantPosition<Rules>::finish(Capture &state, int square, MoveList &moves) const
+{
+    int count = int(state.captured.size());
+    if constexpr (Rules::MajorityCapture)
+    {
+        if (count < state.best)
+            return;
+        if (count > state.best)
+        {
+            moves.clear();
+            state.best = count;
+        }
+    }
+
+    // sequences taking the same pieces to the same square are one move, which
+    // takes going round a cycle of at least four pieces
+    if (count >= 4)
+        for (auto &other : moves)
+            if (other.from == state.from && other.to == square && int(other.captured.size()) == count)
+            {
+                std::bitset<Squares> taken;
+                for (auto victim : other.captured)
+                    taken.set(victim);
+                if (taken == state.taken)
+                    return;
+            }
+
+    Move move;
+    move.from = uint8_t(state.from);
+    move.to = uint8_t(square);
+    move.promotion = state.promoted || (!IsKing && isLastRow<Side>(square));
+    move.captured = state.captured;
+    moves.push_back(std::move(move));
+}
+
+template<class Rules>
+template<int Side, bool IsKing>
+void VariantPosition<Rules>::quiet(int square, MoveList &moves) const
+{
+    forEachDirection([&](auto direction) {
+        constexpr int k = decltype(direction)::value;
+        if constexpr (!IsKing && !isForward<Side>(k))
+            return;
+
+        auto &ray = tables.rays[square][k];
+        int reach = IsKing && Rules::FlyingKings ? ray.length : std::min(ray.length, 1);
+        for (int step = 0; step < reach && !squares[ray.squares[step]]; ++step)
+        {
+            Move move;
+            move.from = uint8_t(square);
+            move.to = ray.squares[step];
+            move.promotion = !IsKing && isLastRow<Side>(move.to);
+            moves.push_back(std::move(move));
+        }
+    });
+}
+
+template<class Rules>
+void VariantPosition<Rules>::play(const Move &move)
+{
+    uint8_t piece = squares[move.from];
+    squares[move.from] = Empty;
+    for (auto square : move.captured)
+        squares[square] = Empty;
+    squares[move.to] = move.promotion ? uint8_t((piece & Side1) | King) : piece;
+    side ^= 1;
+}
+
+template<class Rules>
+uint64_t VariantPosition<Rules>::perft(int depth) const
+{
+    if (depth == 0)
+        return 1;
+    auto moves = generate();
+    if (depth == 1)
+        return moves.size();
+    uint64_t nodes = 0;
+    for (auto &move : moves)
+    {
+        auto next = *this;
+        next.play(move);
+        nodes += next.perft(depth - 1);
+    }
+    return nodes;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+// The rule sets, as compile-time constants so every variant gets a move
+// generator specialized for it (see VariantPosition.h). GameEngine plays
+// International.
+namespace Variants
+{
+
+struct International
+{
+    static constexpr const char *Name = "international";
+    static constexpr int Size = 10;
+    static constexpr int Rows = 4;                      // rows of men each side starts with
+    static constexpr bool MenCaptureBackward = true;
+    static constexpr bool FlyingKings = true;
+    static constexpr bool MajorityCapture = true;       // the sequence taking the most pieces is mandatory
+    static constexpr bool PromoteDuringCapture = false; // a man reaching the last row mid-capture goes on as a king
+};
+
+struct Canadian : International
+{
+    static constexpr const char *Name = "canadian";
+    static constexpr int Size = 12;
+    static constexpr int Rows = 5;
+};
+
+struct Russian
+{
+    static constexpr const char *Name = "russian";
+    static constexpr int Size = 8;
+    static constexpr int Rows = 3;
+    static constexpr bool MenCaptureBackward = true;
+    static constexpr bool FlyingKings = true;
+    static constexpr bool MajorityCapture = false;
+    static constexpr bool PromoteDuringCapture = true;
+};
+
+// also known as checkers
+struct English
+{
+    static constexpr const char *Name = "english";
+    static constexpr int Size = 8;
+    static constexpr int Rows = 3;
+    static constexpr bool MenCaptureBackward = false;
+    static constexpr bool FlyingKings = false;
+    static constexpr bool MajorityCapture = false;
+    static constexpr bool PromoteDuringCapture = false;
+};
+
+}
@@ -1,6 +1,60 @@
 #pragma once
 
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <initializer_list>
 #include "utils/SmallVector.h"
 
 template<typename T>
 using vector = SmallVector<T, 2>;
+
+// A vector with its elements inline and a capacity fixed at compile time,
+// for lists with a known bound that must never reach the heap.
+template<typename T, int N>
+class FixedVector
+{
+public:
+    FixedVector() = default;
+
+    FixedVector(std::initializer_list<T> list)
+    {
+        for (auto &item : list)
+            push_back(item);
+    }
+
+    static constexpr size_t capacity() { return N; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void push_back(const T &item)
+    {
+        assert(count < N);
+        items[count++] = item;
+    }
+
+    void pop_back() { --count; }
+    void clear() { count = 0; }
+
+    T &operator[](size_t i) { return items[i]; }
+    const T &operator[](size_t i) const { return items[i]; }
+    T &front() { return items[0]; }
+    const T &front() const { return items[0]; }
+    T &back() { return items[count - 1]; }
+    const T &back() const { return items[count - 1]; }
+
+    T *begin() { return items.data(); }
+    T *end() { return items.data() + count; }
+    const T *begin() const { return items.data(); }
+    const T *end() const { return items.data() + count; }
+
+    bool operator==(const FixedVector &other) const
+    {
+        return std::equal(begin(), end(), other.begin(), other.end());
+    }
+
+private:
+    std::array<T, N> items{};
+    size_t count = 0;
+};
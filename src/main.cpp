@@ -20,6 +20,7 @@
 
 #include <QApplication>
 #include "Draughts.h"
+#include "Profiler.h"
 
 int main(int argc, char *argv[])
 {
@@ -28,5 +29,11 @@ int main(int argc, char *argv[])
     Draughts *draughts = new Draughts;
     draughts->show();
     
-    return a.exec();
+    int res = a.exec();
+
+    // DRAUGHTS_PROFILE_OUTPUT=file.json saves the profiler's metrics on exit
+    QString profileOutput = qEnvironmentVariable("DRAUGHTS_PROFILE_OUTPUT");
+    if (!profileOutput.isEmpty() && !Profiler::dump(profileOutput))
+        qWarning("Can't write %s", qPrintable(profileOutput));
+    return res;
 }
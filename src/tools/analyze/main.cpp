@@ -0,0 +1,308 @@
+// Batch analysis of saved positions.
+//
+// Runs a fixed depth, node or time search on every position of a set of
+// state files (as written by GameEngine::state, directories are searched
+// recursively) or packed position files, on the global thread pool with one
+// search per worker thread, and writes the best move, score and node count
+// of each as CSV or JSON. Rows keep the order of the input.
+//
+// With --cache, positions already searched as deep (see AnalysisCache.h) are
+// taken from the cache instead, and the new results are merged into it.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <memory>
+#include "AnalysisCache.h"
+#include "Evaluation.h"
+#include "Notation.h"
+#include "PositionFile.h"
+#include "Search.h"
+
+namespace
+{
+
+struct Job
+{
+    QString name;
+    GameEngine position;
+    QString error;
+};
+
+struct Row
+{
+    QString name, side, best, pv, error;
+    Move move;
+    int score = 0, depth = 0;
+    qint64 nodes = 0, time = 0;
+    bool cached = false;
+};
+
+struct Settings
+{
+    Evaluation evaluation;
+    Search::Limits limits;
+    int hashMegabytes = 16;
+    const AnalysisCache *cache = nullptr;
+};
+
+void addStateFile(QString fileName, QString name, vector<Job> &jobs)
+{
+    Job job{name, GameEngine(), QString()};
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        job.error = file.errorString();
+    else
+    {
+        job.position = GameEngine(QString::fromUtf8(file.readAll()));
+        if (job.position.role() < 0 || job.position.role() > 1)
+            job.error = "not a state file";
+        else if (job.position.isFinished())
+            job.error = "game is over";
+    }
+    jobs.push_back(job);
+}
+
+bool addPackedFile(QString fileName, vector<Job> &jobs)
+{
+    PositionFile positions(fileName);
+    if (!positions.open())
+    {
+        qCritical("Can't map %s: %s", qPrintable(fileName), qPrintable(positions.errorString()));
+        return false;
+    }
+    for (qint64 i = 0; i < positions.size(); ++i)
+        jobs.push_back(Job{QString("%1#%2").arg(fileName).arg(i), positions[i].unpack(), QString()});
+    return true;
+}
+
+Row analyze(const Job &job, const Settings &settings)
+{
+    Row row;
+    row.name = job.name;
+    row.error = job.error;
+    if (!row.error.isEmpty())
+        return row;
+    row.side = job.position.whoseTurn() == 1 ? "white" : "black";
+
+    AnalysisCache::Entry cached;
+    if (settings.cache && settings.cache->probe(job.position, cached) && cached.depth >= settings.limits.depth)
+    {
+        row.move = cached.best;
+        row.best = row.pv = Notation::move(cached.best);
+        row.score = cached.score;
+        row.depth = cached.depth;
+        row.cached = true;
+        return row;
+    }
+
+    // a search per pool thread, so the tables are allocated once per worker
+    // instead of once per position
+    thread_local std::unique_ptr<Search> search;
+    if (!search)
+        search.reset(new Search(settings.evaluation, settings.hashMegabytes));
+    // positions are independent, and results must not depend on which
+    // worker happened to get which position before
+    search->newGame();
+
+    auto result = search->run(job.position, settings.limits);
+    if (result.best.isNull())
+    {
+        row.error = "no legal move";
+        return row;
+    }
+    row.move = result.best;
+    row.best = Notation::move(result.best);
+    if (!result.lines.empty())
+        row.pv = Notation::line(result.lines.front().pv);
+    row.score = result.score;
+    row.depth = result.depth;
+    row.nodes = result.nodes + result.qnodes;
+    row.time = result.time;
+    return row;
+}
+
+QString csvField(QString text)
+{
+    if (!text.contains(',') && !text.contains('"'))
+        return text;
+    return '"' + text.replace('"', "\"\"") + '"';
+}
+
+void writeCsv(QTextStream &out, const vector<Row> &rows)
+{
+    out << "position,side,move,score,depth,nodes,time_ms,pv,error\n";
+    for (auto &row : rows)
+        out << csvField(row.name) << ','
+            << row.side << ','
+            << row.best << ','
+            << row.score << ','
+            << row.depth << ','
+            << row.nodes << ','
+            << row.time << ','
+            << row.pv << ','
+            << csvField(row.error) << '\n';
+}
+
+void writeJson(QTextStream &out, const vector<Row> &rows)
+{
+    QJsonArray array;
+    for (auto &row : rows)
+    {
+        QJsonObject object;
+        object["position"] = row.name;
+        if (!row.error.isEmpty())
+            object["error"] = row.error;
+        else
+        {
+            object["side"] = row.side;
+            object["move"] = row.best;
+            object["score"] = row.score;
+            object["depth"] = row.depth;
+            object["nodes"] = row.nodes;
+            object["time_ms"] = row.time;
+            object["pv"] = row.pv;
+        }
+        array.append(object);
+    }
+    out << QJsonDocument(array).toJson(QJsonDocument::Indented);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("draughts-analyze");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Searches every given position and reports the best move, score and nodes.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("inputs", "State files or directories of them, or packed position files with --packed.", "inputs...");
+    QCommandLineOption packedOption({"p", "packed"}, "Inputs are packed position files.");
+    QCommandLineOption depthOption({"d", "depth"}, "Search depth.", "n", "8");
+    QCommandLineOption nodesOption({"n", "nodes"}, "Node limit per position.", "n");
+    QCommandLineOption timeOption({"t", "time"}, "Time per position.", "ms");
+    QCommandLineOption hashOption("hash", "Transposition table per thread.", "MB", "16");
+    QCommandLineOption weightsOption({"w", "weights"}, "Evaluation weights (default: built-in).", "file");
+    QCommandLineOption formatOption({"f", "format"}, "Output format, csv or json.", "format", "csv");
+    QCommandLineOption outputOption({"o", "output"}, "Output file (default: standard output).", "file");
+    QCommandLineOption threadsOption({"j", "threads"}, "Worker threads.", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption cacheOption({"c", "cache"}, "Analysis cache to read and add the results to.", "file");
+    parser.addOptions({packedOption, depthOption, nodesOption, timeOption, hashOption, weightsOption, formatOption, outputOption,
+                       threadsOption, cacheOption});
+    parser.process(app);
+
+    const QString format = parser.value(formatOption);
+    if (parser.positionalArguments().isEmpty() || (format != "csv" && format != "json"))
+        parser.showHelp(1);
+
+    Settings settings;
+    if (parser.isSet(weightsOption) && !settings.evaluation.load(parser.value(weightsOption)))
+    {
+        qCritical("Can't read %s", qPrintable(parser.value(weightsOption)));
+        return 1;
+    }
+    // the cache holds what the built-in weights find
+    if (parser.isSet(weightsOption) && parser.isSet(cacheOption))
+    {
+        qCritical("--cache can't be used with --weights");
+        return 1;
+    }
+    std::unique_ptr<AnalysisCache> cache;
+    if (parser.isSet(cacheOption))
+    {
+        cache.reset(new AnalysisCache(parser.value(cacheOption)));
+        if (!cache->open())
+        {
+            qCritical("Can't open %s: %s", qPrintable(parser.value(cacheOption)), qPrintable(cache->errorString()));
+            return 1;
+        }
+        settings.cache = cache.get();
+    }
+    settings.limits.depth = std::max(1, std::min(parser.value(depthOption).toInt(), MoveOrdering::MaxPly - 1));
+    // a node or time limit alone searches as deep as it allows
+    if (!parser.isSet(depthOption) && (parser.isSet(nodesOption) || parser.isSet(timeOption)))
+        settings.limits.depth = MoveOrdering::MaxPly;
+    settings.limits.nodes = parser.value(nodesOption).toLongLong();
+    settings.limits.moveTime = parser.value(timeOption).toLongLong();
+    settings.hashMegabytes = std::max(1, parser.value(hashOption).toInt());
+    QThreadPool::globalInstance()->setMaxThreadCount(std::max(1, parser.value(threadsOption).toInt()));
+
+    vector<Job> jobs;
+    for (auto &input : parser.positionalArguments())
+    {
+        if (parser.isSet(packedOption))
+        {
+            if (!addPackedFile(input, jobs))
+                return 1;
+        }
+        else if (QFileInfo(input).isDir())
+        {
+            QStringList files;
+            QDirIterator it(input, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext())
+                files << it.next();
+            files.sort();
+            for (auto &file : files)
+                addStateFile(file, file, jobs);
+        }
+        else
+            addStateFile(input, input, jobs);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    auto rows = QtConcurrent::blockingMapped<vector<Row>>(jobs, [&settings](const Job &job) {
+        return analyze(job, settings);
+    });
+    qint64 elapsed = std::max<qint64>(1, timer.elapsed());
+
+    if (cache)
+    {
+        for (size_t i = 0; i < rows.size(); ++i)
+            if (rows[i].error.isEmpty() && !rows[i].cached)
+                cache->store(jobs[i].position, AnalysisCache::Entry{rows[i].move, rows[i].score, rows[i].depth});
+        if (!cache->save())
+            qWarning("Can't save %s: %s", qPrintable(parser.value(cacheOption)), qPrintable(cache->errorString()));
+    }
+
+    QFile file;
+    if (parser.isSet(outputOption))
+    {
+        file.setFileName(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+        {
+            qCritical("Can't write %s: %s", qPrintable(file.fileName()), qPrintable(file.errorString()));
+            return 1;
+        }
+    }
+    else
+        file.open(stdout, QIODevice::WriteOnly);
+    QTextStream out(&file);
+    if (format == "json")
+        writeJson(out, rows);
+    else
+        writeCsv(out, rows);
+    out.flush();
+
+    qint64 nodes = 0, failed = 0, cached = 0;
+    for (auto &row : rows)
+    {
+        nodes += row.nodes;
+        failed += !row.error.isEmpty();
+        cached += row.cached;
+    }
+    QTextStream(stderr) << rows.size() << " positions (" << failed << " failed, " << cached << " cached) in "
+                        << elapsed << " ms, " << nodes * 1000 / elapsed << " nodes/s\n";
+    return failed ? 2 : 0;
+}
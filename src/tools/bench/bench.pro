@@ -0,0 +1,21 @@
+QT       += core
+QT       -= gui
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = draughts-bench
+TEMPLATE = app
+
+include(../../Engine.pri)
+
+# Google Benchmark, e.g. libbenchmark-dev; tools.pro only builds this with it
+packagesExist(benchmark) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += benchmark
+} else {
+    LIBS += -lbenchmark -lpthread
+}
+
+DEFINES += DRAUGHTS_DATA_DIR=\\\"$$PWD/../../../data\\\"
+
+SOURCES += main.cpp
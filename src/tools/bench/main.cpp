@@ -0,0 +1,264 @@
+// Micro-benchmarks of the engine's hot paths, on Google Benchmark.
+//
+// Every benchmark runs on the saved positions data/test1..3 and on a few
+// middlegames reached by seeded random play from the initial position, so
+// runs are comparable between builds and machines. Results are written as
+// JSON unless another --benchmark_format is asked for; --data=dir reads the
+// saved positions from elsewhere.
+//
+// operator new is replaced to count the heap allocations of each thread, the
+// search benchmark reports them: they depend on the iterations and the root,
+// never on the number of nodes.
+
+#include <benchmark/benchmark.h>
+#include <QFile>
+#include <QTextStream>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "Evaluation.h"
+#include "GameEngine.h"
+#include "MoveGenerator.h"
+#include "Search.h"
+
+namespace
+{
+
+thread_local int64_t heapAllocations = 0;
+
+}
+
+void *operator new(size_t size)
+{
+    ++heapAllocations;
+    if (void *memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+namespace
+{
+
+const int SEARCH_DEPTH = 6;
+const int MIDDLEGAMES = 4;
+const int MIDDLEGAME_PLIES = 24;
+
+struct Position
+{
+    std::string name;
+    GameEngine engine;
+};
+
+bool loadPosition(QString fileName, GameEngine &engine)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return false;
+    engine = GameEngine(QTextStream(&file).readAll());
+    return true;
+}
+
+// deterministic for a seed, so every run measures the same positions
+GameEngine middlegame(unsigned seed)
+{
+    std::mt19937 rng(seed);
+    GameEngine engine(0, 0);
+    for (int ply = 0; ply < MIDDLEGAME_PLIES; ++ply)
+    {
+        auto moves = MoveGenerator::generate(engine);
+        if (moves.empty())
+            break;
+        auto next = MoveGenerator::play(engine, moves[rng() % moves.size()]);
+        if (MoveGenerator::generate(next).empty())
+            break;
+        engine = next;
+    }
+    return engine;
+}
+
+std::vector<Position> positions(const std::string &dataDir)
+{
+    std::vector<Position> res;
+    for (int i = 1; i <= 3; ++i)
+    {
+        GameEngine engine;
+        QString fileName = QString::fromStdString(dataDir) + QString("/test%1").arg(i);
+        if (loadPosition(fileName, engine))
+            res.push_back(Position{"test" + std::to_string(i), engine});
+        else
+            fprintf(stderr, "Can't read %s, skipped\n", qPrintable(fileName));
+    }
+    for (int i = 1; i <= MIDDLEGAMES; ++i)
+        res.push_back(Position{"middlegame" + std::to_string(i), middlegame(unsigned(i))});
+    return res;
+}
+
+void copy(benchmark::State &state, const GameEngine &engine)
+{
+    for (auto _ : state)
+    {
+        GameEngine copy = engine;
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+void updateMovable(benchmark::State &state, GameEngine engine)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(engine.updateMovable());
+}
+
+// the destinations of every piece that may move, as the GUI asks for them
+void nextCells(benchmark::State &state, GameEngine engine)
+{
+    engine.updateMovable();
+    GameEngine::Cells movable;
+    for (int i = 0; i < GameEngine::Size; ++i)
+        for (int j = 0; j < GameEngine::Size; ++j)
+            if (engine.board.get(i, j).isMovable())
+                movable.push_back(QPoint(i, j));
+    for (auto _ : state)
+        for (auto &p : movable)
+            benchmark::DoNotOptimize(engine.nextCells(p.x(), p.y()));
+    state.SetItemsProcessed(state.iterations() * int64_t(movable.size()));
+}
+
+void generate(benchmark::State &state, const GameEngine &engine)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(MoveGenerator::generate(engine));
+}
+
+// includes copying the engine, see the copy benchmark
+void move(benchmark::State &state, const GameEngine &engine)
+{
+    auto moves = MoveGenerator::generate(engine);
+    if (moves.empty())
+        return state.SkipWithError("no legal move");
+    auto path = MoveGenerator::hops(engine, moves.front());
+    for (auto _ : state)
+    {
+        GameEngine next = engine;
+        for (size_t k = 1; k < path.size(); ++k)
+            benchmark::DoNotOptimize(next.move(path[k - 1], path[k]));
+    }
+}
+
+// includes copying the engine, see the copy benchmark
+void applyMoveAchievements(benchmark::State &state, const GameEngine &engine)
+{
+    auto moves = MoveGenerator::generate(engine);
+    if (moves.empty())
+        return state.SkipWithError("no legal move");
+    auto path = MoveGenerator::hops(engine, moves.front());
+    GameEngine moved = engine;
+    for (size_t k = 1; k < path.size(); ++k)
+        moved.move(path[k - 1], path[k]);
+    for (auto _ : state)
+    {
+        GameEngine next = moved;
+        benchmark::DoNotOptimize(next.applyMoveAchievements(path.back()));
+    }
+}
+
+void writeState(benchmark::State &state, const GameEngine &engine)
+{
+    for (auto _ : state)
+        benchmark::DoNotOptimize(engine.state());
+}
+
+void readState(benchmark::State &state, const GameEngine &engine)
+{
+    QString text = engine.state();
+    GameEngine read;
+    for (auto _ : state)
+    {
+        read.readState(text);
+        benchmark::DoNotOptimize(read);
+    }
+}
+
+// a fixed depth search from empty tables each time, after one to warm up the
+// arena of the thread
+void search(benchmark::State &state, const GameEngine &engine)
+{
+    Search search(Evaluation(), 16);
+    Search::Limits limits;
+    limits.depth = SEARCH_DEPTH;
+    search.run(engine, limits);
+    int64_t nodes = 0, allocations = 0;
+    for (auto _ : state)
+    {
+        search.newGame();
+        int64_t before = heapAllocations;
+        auto result = search.run(engine, limits);
+        allocations += heapAllocations - before;
+        nodes += result.nodes + result.qnodes;
+        benchmark::DoNotOptimize(result);
+    }
+    double iterations = double(state.iterations());
+    state.counters["nodes"] = benchmark::Counter(double(nodes) / iterations);
+    state.counters["nps"] = benchmark::Counter(double(nodes), benchmark::Counter::kIsRate);
+    state.counters["allocations"] = benchmark::Counter(double(allocations) / iterations);
+    state.counters["allocations/node"] = benchmark::Counter(double(allocations) / double(std::max<int64_t>(nodes, 1)));
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    std::string dataDir = DRAUGHTS_DATA_DIR;
+    std::vector<char *> args;
+    bool formatGiven = false;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (!strncmp(argv[i], "--data=", 7))
+            dataDir = argv[i] + 7;
+        else
+        {
+            formatGiven |= !strncmp(argv[i], "--benchmark_format=", 19);
+            args.push_back(argv[i]);
+        }
+    }
+    static char json[] = "--benchmark_format=json";
+    if (!formatGiven)
+        args.push_back(json);
+    int count = int(args.size());
+
+    for (auto &position : positions(dataDir))
+    {
+        auto add = [&](const char *name, auto function) {
+            benchmark::RegisterBenchmark((std::string(name) + "/" + position.name).c_str(), function, position.engine);
+        };
+        add("copy", copy);
+        add("updateMovable", updateMovable);
+        add("nextCells", nextCells);
+        add("generate", generate);
+        add("move", move);
+        add("applyMoveAchievements", applyMoveAchievements);
+        add("state", writeState);
+        add("readState", readState);
+        benchmark::RegisterBenchmark(("search/" + position.name).c_str(), search, position.engine)
+            ->Unit(benchmark::kMillisecond);
+    }
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
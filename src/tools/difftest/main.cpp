@@ -0,0 +1,127 @@
+// Differential test of the move generators.
+//
+// Compares MoveGenerator against VariantPosition (see GeneratorCheck.h) on
+// random positions: reachable ones from RandomPositions, and with --arbitrary
+// as many again with pieces thrown on the board, which no game may reach but
+// readState accepts. Every difference is printed with the position's state;
+// the exit code is 1 if there was any. Positions depend on the seed only.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <random>
+#include "GeneratorCheck.h"
+#include "RandomPositions.h"
+
+namespace
+{
+
+constexpr qint64 BlockSize = 1024;
+
+struct Block
+{
+    qint64 begin, end;
+};
+
+struct Difference
+{
+    QString position, description;
+};
+
+// men on any dark square but their last row, kings anywhere
+GameEngine arbitrary(uint64_t seed, qint64 index)
+{
+    constexpr int Size = GameEngine::Size;
+    std::mt19937_64 rng(seed ^ (uint64_t(index) * 0x9e3779b97f4a7c15ull));
+    int side = int(rng() % 2);
+    GameEngine engine(side, side);
+    int pieces[2] = {0, 0};
+    int density = 10 + int(rng() % 60); // percent of the dark squares
+    for (int x = 0; x < Size; ++x)
+        for (int y = 0; y < Size; ++y)
+        {
+            auto &cell = engine.board.get(x, y);
+            cell.setOccupier(-1);
+            if (!((x + y) & 1) || int(rng() % 100) >= density)
+                continue;
+            int occupier = int(rng() % 2);
+            bool king = rng() % 4 == 0 || x == (occupier == 0 ? 0 : Size - 1);
+            if (pieces[occupier] < GameEngine::Rules::Rows * Size / 2)
+            {
+                ++pieces[occupier];
+                cell.setOccupier(occupier, king);
+            }
+        }
+    return engine;
+}
+
+vector<Difference> check(const RandomPositions &generator, bool withArbitrary, Block block)
+{
+    vector<Difference> res;
+    auto test = [&res](const QString &name, const GameEngine &engine) {
+        QString description = GeneratorCheck::compare(engine);
+        if (!description.isEmpty())
+            res.push_back(Difference{name + "\n" + engine.state(), description});
+    };
+    for (qint64 i = block.begin; i < block.end; ++i)
+    {
+        PackedPosition position;
+        if (generator.generate(uint64_t(i), position))
+            test(QString("reachable #%1").arg(i), position.unpack());
+        if (withArbitrary)
+            test(QString("arbitrary #%1").arg(i), arbitrary(generator.settings().seed, i));
+    }
+    return res;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("draughts-difftest");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares the move generators on random positions.");
+    parser.addHelpOption();
+    QCommandLineOption countOption({"n", "count"}, "Positions of each kind.", "n", "100000");
+    QCommandLineOption seedOption({"s", "seed"}, "Seed of the positions.", "n", "1");
+    QCommandLineOption arbitraryOption({"a", "arbitrary"}, "Also positions no game reaches.");
+    QCommandLineOption threadsOption({"j", "threads"}, "Worker threads.", "n", QString::number(QThread::idealThreadCount()));
+    parser.addOptions({countOption, seedOption, arbitraryOption, threadsOption});
+    parser.process(app);
+
+    RandomPositions::Settings settings;
+    settings.seed = parser.value(seedOption).toULongLong();
+    RandomPositions generator(settings);
+    bool withArbitrary = parser.isSet(arbitraryOption);
+    qint64 count = std::max<qint64>(0, parser.value(countOption).toLongLong());
+    QThreadPool::globalInstance()->setMaxThreadCount(std::max(1, parser.value(threadsOption).toInt()));
+
+    vector<Block> blocks;
+    for (qint64 i = 0; i < count; i += BlockSize)
+        blocks.push_back(Block{i, std::min(count, i + BlockSize)});
+
+    QElapsedTimer timer;
+    timer.start();
+    auto results = QtConcurrent::blockingMapped<vector<vector<Difference>>>(blocks, [&](Block block) {
+        return check(generator, withArbitrary, block);
+    });
+    qint64 elapsed = std::max<qint64>(1, timer.elapsed());
+
+    QTextStream out(stdout);
+    qint64 differences = 0;
+    for (auto &result : results)
+        for (auto &difference : result)
+        {
+            out << difference.position << difference.description << "\n\n";
+            ++differences;
+        }
+    out.flush();
+    QTextStream(stderr) << count * (withArbitrary ? 2 : 1) << " positions, " << differences << " differences in "
+                        << elapsed << " ms\n";
+    return differences ? 1 : 0;
+}
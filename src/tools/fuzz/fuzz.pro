@@ -0,0 +1,20 @@
+QT       += core
+QT       -= gui
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = draughts-fuzz
+TEMPLATE = app
+
+include(../../Engine.pri)
+
+# qmake CONFIG+=libfuzzer builds a libFuzzer target with clang; otherwise the
+# harness has a main() running the inputs given as files or on standard input,
+# which is what AFL needs (QMAKE_CXX=afl-clang-fast++).
+libfuzzer {
+    DEFINES += DRAUGHTS_LIBFUZZER
+    QMAKE_CXXFLAGS += -fsanitize=fuzzer,address,undefined
+    QMAKE_LFLAGS += -fsanitize=fuzzer,address,undefined
+}
+
+SOURCES += main.cpp
@@ -0,0 +1,133 @@
+// Fuzz target for the rules code that reads untrusted input.
+//
+// An input is a state text, as GameEngine::state writes it, optionally
+// followed by a 0 byte and hops of two bytes, each byte a square modulo the
+// board. readState has to refuse the state or give a position that reads
+// back the same, on which both move generators agree (see GeneratorCheck.h).
+// The hops are then played the way a network peer sends them: whatever
+// isLegalHop lets through goes to move, and every move completed that way
+// has to be one of MoveGenerator's and lead to the same position. A broken
+// invariant aborts, which is what the fuzzers report.
+//
+// Built with CONFIG+=libfuzzer this is a libFuzzer target. Otherwise main()
+// runs the files given, or standard input, once each, for AFL and for
+// replaying a crash. The saved states in data/ make a seed corpus.
+
+#include <QFile>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include "GeneratorCheck.h"
+#include "MoveGenerator.h"
+
+namespace
+{
+
+constexpr int Size = GameEngine::Size;
+
+[[noreturn]] void fail(const char *what, const QString &detail)
+{
+    fprintf(stderr, "%s\n%s\n", what, qPrintable(detail));
+    abort();
+}
+
+bool isSame(const GameEngine &a, const GameEngine &b)
+{
+    for (int square = 0; square < Size * Size; ++square)
+    {
+        auto &x = a.board.get(square), &y = b.board.get(square);
+        if (x.occupier() != y.occupier() || x.isKing() != y.isKing())
+            return false;
+    }
+    return a.whoseTurn() == b.whoseTurn() && a.role() == b.role();
+}
+
+QPoint cell(uint8_t byte)
+{
+    int square = byte % (Size * Size);
+    return QPoint(square / Size, square % Size);
+}
+
+void run(const uint8_t *data, size_t size)
+{
+    const uint8_t *end = data + size, *split = std::find(data, end, 0);
+    GameEngine engine;
+    if (!engine.readState(QString::fromLatin1(reinterpret_cast<const char *>(data), int(split - data))))
+        return;
+    GameEngine read;
+    if (!read.readState(engine.state()) || !isSame(engine, read))
+        fail("The state doesn't read back:", engine.state());
+    if (engine.isFinished())
+        return;
+    auto difference = GeneratorCheck::compare(engine);
+    if (!difference.isEmpty())
+        fail("The generators differ:", difference + "\n" + engine.state());
+    if (split == end || !engine.updateMovable())
+        return;
+
+    GameEngine before = engine;
+    Move move;
+    for (auto hop = split + 1; hop + 1 < end; hop += 2)
+    {
+        QPoint S = cell(hop[0]), E = cell(hop[1]);
+        bool capturing = !move.isNull();
+        if ((capturing && S != move.to()) || !engine.isLegalHop(S, E, capturing))
+            continue;
+        MoveGenerator::addHop(engine, move, S, E);
+        if (engine.move(S, E) && !engine.nextCells(E.x(), E.y(), true).empty())
+            continue;
+
+        engine.applyMoveAchievements(E);
+        engine.switchWhoseTurn();
+        Arena::Scope scope;
+        auto moves = MoveGenerator::generate(before);
+        if (std::find(moves.begin(), moves.end(), move) == moves.end())
+            fail("An illegal move was played:", move.pack() + "\n" + before.state());
+        if (!isSame(engine, MoveGenerator::play(before, move)))
+            fail("The hops and the move lead to different positions:", move.pack() + "\n" + before.state());
+        if (!engine.updateMovable())
+            return;
+        before = engine;
+        move = Move{};
+    }
+}
+
+}
+
+#ifdef DRAUGHTS_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    run(data, size);
+    return 0;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    auto runFile = [](QFile &file) {
+        QByteArray input = file.readAll();
+        run(reinterpret_cast<const uint8_t *>(input.constData()), size_t(input.size()));
+    };
+    if (argc < 2)
+    {
+        QFile file;
+        file.open(stdin, QIODevice::ReadOnly);
+        runFile(file);
+    }
+    for (int i = 1; i < argc; ++i)
+    {
+        QFile file(QString::fromLocal8Bit(argv[i]));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            fprintf(stderr, "Can't read %s\n", argv[i]);
+            return 1;
+        }
+        runFile(file);
+    }
+    return 0;
+}
+
+#endif
@@ -0,0 +1,211 @@
+#include "HubEngine.h"
+#include "Notation.h"
+#include <QtConcurrent>
+#include <algorithm>
+
+HubEngine::HubEngine(QObject *parent)
+    : QObject(parent), position(1, 1)
+{
+    watcher = new QFutureWatcher<Search::Result>(this);
+    connect(watcher, &QFutureWatcher<Search::Result>::finished, this, &HubEngine::searchFinished);
+
+    // runs on the searching thread; the receivers of send live on the main
+    // thread, so the line is queued to it
+    search.setInfoCallback([this](const Search::Result &result) {
+        if (result.lines.empty())
+            return;
+        qint64 nodes = result.nodes + result.qnodes;
+        emit send(QString("info depth=%1 score=%2 nodes=%3 time=%4 nps=%5 pv=\"%6\"")
+                  .arg(result.depth)
+                  .arg(result.score / 100.0, 0, 'f', 2)
+                  .arg(nodes)
+                  .arg(result.time / 1000.0, 0, 'f', 3)
+                  .arg(nodes * 1000 / std::max<qint64>(result.time, 1))
+                  .arg(Notation::line(result.lines.front().pv)));
+    });
+}
+
+HubEngine::~HubEngine()
+{
+    stopSearch();
+}
+
+// key=value pairs after the command, values may be quoted
+QMap<QString, QString> HubEngine::arguments(QString line)
+{
+    QMap<QString, QString> res;
+    int i = line.indexOf(' ');
+    while (i >= 0 && i < line.size())
+    {
+        while (i < line.size() && line[i] == ' ')
+            ++i;
+        int eq = line.indexOf('=', i);
+        int space = line.indexOf(' ', i);
+        if (eq < 0 || (space >= 0 && space < eq))
+        {
+            // a bare flag such as "infinite"
+            QString key = line.mid(i, space < 0 ? -1 : space - i);
+            if (!key.isEmpty())
+                res[key] = "";
+            i = space;
+            continue;
+        }
+        QString key = line.mid(i, eq - i);
+        int end;
+        if (eq + 1 < line.size() && line[eq + 1] == '"')
+        {
+            end = line.indexOf('"', eq + 2);
+            if (end < 0)
+                end = line.size();
+            res[key] = line.mid(eq + 2, end - eq - 2);
+            ++end;
+        }
+        else
+        {
+            end = line.indexOf(' ', eq);
+            if (end < 0)
+                end = line.size();
+            res[key] = line.mid(eq + 1, end - eq - 1);
+        }
+        i = end;
+    }
+    return res;
+}
+
+void HubEngine::handleLine(QString line)
+{
+    line = line.trimmed();
+    QString command = line.section(' ', 0, 0);
+    auto args = arguments(line);
+
+    if (command == "hub")
+    {
+        emit send("id name=Draughts version=1.0");
+        emit send("param name=hash value=16 type=int min=1 max=4096");
+        emit send("wait");
+    }
+    else if (command == "init")
+        emit send("ready");
+    else if (command == "ping")
+        emit send("pong");
+    else if (command == "set-param")
+    {
+        if (args.value("name") == "hash")
+        {
+            stopSearch();
+            search.setHashSize(std::max(1, args.value("value").toInt()));
+        }
+    }
+    else if (command == "new-game")
+    {
+        stopSearch();
+        search.newGame();
+    }
+    else if (command == "pos")
+    {
+        stopSearch();
+        GameEngine engine;
+        if (!Notation::readPosition(args.value("pos", "Wbbbbbbbbbbbbbbbbbbbbeeeeeeeeeewwwwwwwwwwwwwwwwwwww"), engine))
+            return emit send("error message=\"bad position\"");
+        GameHistory played;
+        played.reset(engine);
+        for (auto &text : args.value("moves").split(' ', QString::SkipEmptyParts))
+        {
+            Move move;
+            if (!Notation::findMove(engine, text, move))
+                return emit send(QString("error message=\"illegal move %1\"").arg(text));
+            played.push(engine, move);
+            engine = MoveGenerator::play(engine, move);
+        }
+        position = engine;
+        history = played;
+    }
+    else if (command == "level")
+    {
+        limits = Search::Limits{};
+        limits.depth = MoveOrdering::MaxPly;
+        if (args.contains("depth"))
+            limits.depth = args.value("depth").toInt();
+        if (args.contains("nodes"))
+            limits.nodes = args.value("nodes").toLongLong();
+        if (args.contains("move-time"))
+            limits.moveTime = qint64(args.value("move-time").toDouble() * 1000);
+        if (args.contains("time"))
+        {
+            limits.time = qint64(args.value("time").toDouble() * 1000);
+            limits.increment = qint64(args.value("inc").toDouble() * 1000);
+            limits.movesToGo = args.value("moves").toInt();
+        }
+    }
+    else if (command == "go")
+        go(args.contains("analyze"), args.contains("ponder"));
+    else if (command == "stop")
+    {
+        pondering = false;
+        search.stop();
+        if (watcher->isFinished())
+            searchFinished();
+    }
+    else if (command == "ponder-hit")
+    {
+        if (!pondering)
+            return;
+        pondering = false;
+        // a search that ran out of moves to think about answers at once
+        if (watcher->isFinished())
+            searchFinished();
+        else
+            search.ponderHit(ticket, limits);
+    }
+    else if (command == "quit")
+    {
+        stopSearch();
+        emit quit();
+    }
+    else if (!command.isEmpty())
+        emit send(QString("error message=\"unknown command %1\"").arg(command));
+}
+
+void HubEngine::go(bool analyze, bool ponder)
+{
+    stopSearch();
+    reportResult = true;
+    pondering = ponder;
+    auto searchLimits = limits;
+    if (analyze || ponder)
+    {
+        searchLimits = Search::Limits{};
+        searchLimits.depth = MoveOrdering::MaxPly;
+    }
+    auto root = position;
+    auto played = history;
+    ticket = search.ticket();
+    watcher->setFuture(QtConcurrent::run([this, root, searchLimits, played, ticket = ticket] {
+        return search.run(root, searchLimits, played, ticket);
+    }));
+}
+
+// cancels the search without answering it, unlike the "stop" command; the
+// stop holds for a search still queued, so the wait is short either way
+void HubEngine::stopSearch()
+{
+    reportResult = false;
+    pondering = false;
+    search.stop();
+    watcher->waitForFinished();
+}
+
+void HubEngine::searchFinished()
+{
+    if (!reportResult || pondering)
+        return;
+    reportResult = false;
+    auto result = watcher->result();
+    if (result.best.isNull())
+        return emit send("error message=\"no legal move\"");
+
+    QString done = "done move=" + Notation::move(result.best);
+    if (!result.lines.empty() && result.lines.front().pv.size() > 1)
+        done += " ponder=" + Notation::move(result.lines.front().pv[1]);
+    emit send(done);
+}
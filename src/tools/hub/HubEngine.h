@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QMap>
+#include "GameEngine.h"
+#include "Search.h"
+
+// Hub protocol front end of the search (the text protocol of Scan and the
+// tournament managers built around it): one command per line in, one reply
+// per line out. Commands are handled on the thread owning the object while
+// the search runs on the thread pool, so "stop" takes effect at once.
+// Positions and moves are in the standard notation, see Notation.h.
+class HubEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit HubEngine(QObject *parent = nullptr);
+    ~HubEngine();
+
+public slots:
+    void handleLine(QString line);
+
+signals:
+    void send(QString line);
+    void quit();
+
+private slots:
+    void searchFinished();
+
+private:
+    static QMap<QString, QString> arguments(QString line);
+    void go(bool analyze, bool ponder);
+    void stopSearch();
+
+    GameEngine position;
+    GameHistory history; // the moves given with the position, for the draw rules
+    Search search;
+    Search::Limits limits;
+    QFutureWatcher<Search::Result> *watcher;
+    quint64 ticket = 0; // of the last search started
+    bool reportResult = false;
+    bool pondering = false; // the result waits for "ponder-hit" or "stop"
+};
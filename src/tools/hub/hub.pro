@@ -0,0 +1,15 @@
+QT       += core network concurrent
+QT       -= gui
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = draughts-hub
+TEMPLATE = app
+
+include(../../Engine.pri)
+
+SOURCES += main.cpp \
+    HubEngine.cpp
+
+HEADERS += \
+    HubEngine.h
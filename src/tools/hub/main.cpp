@@ -0,0 +1,81 @@
+// Stand-alone engine speaking the Hub protocol, on stdin/stdout by default or
+// to a single client over TCP with --port.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "HubEngine.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("draughts-hub");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Draughts engine for Hub protocol GUIs and tournament managers.");
+    parser.addHelpOption();
+    QCommandLineOption portOption({"p", "port"}, "Listen for one TCP client instead of using stdin/stdout.", "port");
+    parser.addOption(portOption);
+    parser.process(app);
+
+    HubEngine engine;
+    QObject::connect(&engine, &HubEngine::quit, &app, &QCoreApplication::quit, Qt::QueuedConnection);
+
+    QTextStream out(stdout);
+    QTcpServer server;
+    std::thread reader;
+    if (parser.isSet(portOption))
+    {
+        if (!server.listen(QHostAddress::Any, quint16(parser.value(portOption).toUInt())))
+        {
+            qCritical("Can't listen: %s", qPrintable(server.errorString()));
+            return 1;
+        }
+        QObject::connect(&server, &QTcpServer::newConnection, [&] {
+            QTcpSocket *socket = server.nextPendingConnection();
+            server.close();
+            QObject::connect(&engine, &HubEngine::send, socket, [socket](QString line) {
+                socket->write((line + "\n").toUtf8());
+            });
+            QObject::connect(socket, &QTcpSocket::readyRead, [socket, &engine] {
+                while (socket->canReadLine())
+                    engine.handleLine(QString::fromUtf8(socket->readLine()));
+            });
+            QObject::connect(socket, &QTcpSocket::disconnected, &app, &QCoreApplication::quit);
+        });
+    }
+    else
+    {
+        // app as the context queues the lines from the searching thread, so
+        // only the main thread writes to out
+        QObject::connect(&engine, &HubEngine::send, &app, [&out](QString line) {
+            out << line << "\n";
+            out.flush();
+        });
+        // blocking reads stay off the event loop, which keeps serving the
+        // search output and "stop" while a search runs; the reader ends
+        // with the input or at "quit", the only ways out, and is joined
+        // before engine and app go
+        reader = std::thread([&engine, &app] {
+            std::string line;
+            while (std::getline(std::cin, line))
+            {
+                QString text = QString::fromStdString(line);
+                QMetaObject::invokeMethod(&engine, [&engine, text] { engine.handleLine(text); }, Qt::QueuedConnection);
+                if (text.trimmed() == "quit")
+                    return;
+            }
+            QMetaObject::invokeMethod(&app, &QCoreApplication::quit, Qt::QueuedConnection);
+        });
+    }
+
+    int res = app.exec();
+    if (reader.joinable())
+        reader.join();
+    return res;
+}
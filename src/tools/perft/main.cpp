@@ -0,0 +1,65 @@
+// Move generator node counts of the variants.
+//
+// Counts the leaves of the full move tree from the initial position of a
+// variant, depth by depth, with the generator specialized for it (see
+// VariantPosition.h). The counts are the standard check of a move
+// generator against the published ones.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <algorithm>
+#include "VariantPosition.h"
+
+namespace
+{
+
+template<class Rules>
+void perft(int depth, QTextStream &out)
+{
+    auto position = VariantPosition<Rules>::initial();
+    out << Rules::Name << " " << Rules::Size << "x" << Rules::Size << "\n";
+    for (int d = 1; d <= depth; ++d)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        quint64 nodes = position.perft(d);
+        qint64 time = timer.elapsed();
+        out << QString("depth %1 nodes %2 time %3 ms nps %4")
+               .arg(d, 2).arg(nodes, 12).arg(time, 8).arg(nodes * 1000 / quint64(std::max<qint64>(time, 1)))
+            << "\n";
+        out.flush();
+    }
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("draughts-perft");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Counts the move tree of a variant from its initial position.");
+    parser.addHelpOption();
+    QCommandLineOption variantOption({"v", "variant"}, "international, canadian, russian or english.", "name", "international");
+    QCommandLineOption depthOption({"d", "depth"}, "Depth to count up to.", "n", "6");
+    parser.addOptions({variantOption, depthOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    int depth = std::max(1, parser.value(depthOption).toInt());
+    QString variant = parser.value(variantOption);
+    if (variant == Variants::International::Name)
+        perft<Variants::International>(depth, out);
+    else if (variant == Variants::Canadian::Name)
+        perft<Variants::Canadian>(depth, out);
+    else if (variant == Variants::Russian::Name)
+        perft<Variants::Russian>(depth, out);
+    else if (variant == Variants::English::Name)
+        perft<Variants::English>(depth, out);
+    else
+        parser.showHelp(1);
+    return 0;
+}
@@ -0,0 +1,11 @@
+QT       += core
+QT       -= gui
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = draughts-perft
+TEMPLATE = app
+
+include(../../Engine.pri)
+
+SOURCES += main.cpp
@@ -0,0 +1,154 @@
+// Bulk generator of random reachable positions.
+//
+// Writes a packed position file (see PositionFile.h) of positions reached by
+// random playouts from the initial position, with the number of pieces and
+// the share of kings within the given bounds (see RandomPositions.h). Each
+// position is labelled with the result a search of --label-depth predicts
+// for the side to move, which is what the tuner fits the weights to; with a
+// depth of 0 they are all draws and need scoring before tuning. The
+// positions are generated in blocks on the global thread pool and written in
+// index order, so a seed gives the same file whatever the number of threads.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include "RandomPositions.h"
+#include "Search.h"
+
+namespace
+{
+
+constexpr qint64 BlockSize = 4096;
+constexpr int DrawMargin = 100; // a search score within a man of 0 counts as a draw
+
+struct Block
+{
+    qint64 begin, end;
+};
+
+struct Generated
+{
+    vector<PackedPosition> positions;
+    qint64 failed = 0;
+};
+
+// the result for the side to move a search of depth predicts
+int label(Search &search, const PackedPosition &position, int depth)
+{
+    Search::Limits limits;
+    limits.depth = depth;
+    auto result = search.run(position.unpack(), limits);
+    if (result.best.isNull() || result.score < -DrawMargin)
+        return -1;
+    return result.score > DrawMargin ? 1 : 0;
+}
+
+Generated generate(const RandomPositions &generator, Block block, int depth)
+{
+    Generated res;
+    res.positions.reserve(block.end - block.begin);
+    // one search per block, so the labels don't depend on the threads either
+    Search search(Evaluation(), 1);
+    for (qint64 i = block.begin; i < block.end; ++i)
+    {
+        PackedPosition position;
+        if (!generator.generate(uint64_t(i), position))
+        {
+            ++res.failed;
+            continue;
+        }
+        if (depth > 0)
+            position.result = int8_t(label(search, position, depth));
+        res.positions.push_back(position);
+    }
+    return res;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("draughts-positions");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes random positions reachable from the initial one to a packed position file, "
+                                     "labelled by a search for the tuner.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("output", "Packed position file to write.");
+    QCommandLineOption countOption({"n", "count"}, "Positions to generate.", "n", "1000000");
+    QCommandLineOption seedOption({"s", "seed"}, "Seed of the playouts.", "n", "1");
+    QCommandLineOption minPiecesOption("min-pieces", "Least pieces on the board, both sides.", "n", "2");
+    QCommandLineOption maxPiecesOption("max-pieces", "Most pieces on the board, both sides.", "n", "40");
+    QCommandLineOption minKingsOption("min-kings", "Least share of kings among the pieces.", "percent", "0");
+    QCommandLineOption maxKingsOption("max-kings", "Most share of kings among the pieces.", "percent", "100");
+    QCommandLineOption quietOption({"q", "quiet"}, "Only positions where the side to move has no capture.");
+    QCommandLineOption labelDepthOption("label-depth", "Depth of the search labelling the positions, 0 to leave them all draws.",
+                                        "n", "6");
+    QCommandLineOption threadsOption({"j", "threads"}, "Worker threads.", "n", QString::number(QThread::idealThreadCount()));
+    parser.addOptions({countOption, seedOption, minPiecesOption, maxPiecesOption, minKingsOption, maxKingsOption,
+                       quietOption, labelDepthOption, threadsOption});
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+    QString fileName = parser.positionalArguments().front();
+
+    RandomPositions::Settings settings;
+    settings.seed = parser.value(seedOption).toULongLong();
+    settings.minPieces = std::max(2, parser.value(minPiecesOption).toInt());
+    settings.maxPieces = std::min(2 * GameEngine::Rules::Rows * GameEngine::Size / 2, parser.value(maxPiecesOption).toInt());
+    settings.minKings = std::max(0.0, parser.value(minKingsOption).toDouble() / 100);
+    settings.maxKings = std::min(1.0, parser.value(maxKingsOption).toDouble() / 100);
+    settings.quiet = parser.isSet(quietOption);
+    if (settings.minPieces > settings.maxPieces || settings.minKings > settings.maxKings)
+    {
+        qCritical("Empty range of pieces or kings");
+        return 1;
+    }
+    RandomPositions generator(settings);
+    qint64 count = std::max<qint64>(0, parser.value(countOption).toLongLong());
+    int depth = std::min(std::max(0, parser.value(labelDepthOption).toInt()), MoveOrdering::MaxPly - 1);
+    int threads = std::max(1, parser.value(threadsOption).toInt());
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qCritical("Can't write %s: %s", qPrintable(fileName), qPrintable(file.errorString()));
+        return 1;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    qint64 written = 0, failed = 0;
+    // a few blocks per thread at a time keeps the memory bounded
+    for (qint64 begin = 0; begin < count; begin += BlockSize * threads * 4)
+    {
+        vector<Block> blocks;
+        for (qint64 i = begin; i < std::min(count, begin + BlockSize * threads * 4); i += BlockSize)
+            blocks.push_back(Block{i, std::min(count, i + BlockSize)});
+        auto results = QtConcurrent::blockingMapped<vector<Generated>>(blocks, [&generator, depth](Block block) {
+            return generate(generator, block, depth);
+        });
+        for (auto &result : results)
+        {
+            qint64 bytes = qint64(result.positions.size() * sizeof(PackedPosition));
+            if (file.write(reinterpret_cast<const char *>(result.positions.data()), bytes) != bytes)
+            {
+                qCritical("Can't write %s: %s", qPrintable(fileName), qPrintable(file.errorString()));
+                return 1;
+            }
+            written += qint64(result.positions.size());
+            failed += result.failed;
+        }
+    }
+
+    qint64 elapsed = std::max<qint64>(1, timer.elapsed());
+    QTextStream(stderr) << written << " positions (" << failed << " not found) in " << elapsed << " ms, "
+                        << written * 1000 / elapsed << " positions/s\n";
+    return failed ? 2 : 0;
+}
@@ -0,0 +1,11 @@
+QT       += core concurrent
+QT       -= gui
+CONFIG   += c++17 console
+CONFIG   -= app_bundle
+
+TARGET = draughts-positions
+TEMPLATE = app
+
+include(../../Engine.pri)
+
+SOURCES += main.cpp
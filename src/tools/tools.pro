@@ -0,0 +1,16 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tuner \
+    analyze \
+    perft \
+    positions \
+    fuzz \
+    difftest \
+    hub
+
+# Google Benchmark, e.g. libbenchmark-dev, found by pkg-config or given with
+# qmake CONFIG+=benchmark
+packagesExist(benchmark)|benchmark {
+    SUBDIRS += bench
+}
@@ -0,0 +1,192 @@
+// Texel-style tuner for the evaluation weights.
+//
+// Minimises the mean squared error between the game result stored with each
+// position and sigmoid(evaluation) over a memory-mapped position file, using
+// mini-batch gradient descent (Adam step sizes). Batches are evaluated in
+// parallel on the global thread pool.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include "Evaluation.h"
+#include "PositionFile.h"
+
+namespace
+{
+
+constexpr int N = Evaluation::FeatureCount;
+using Vec = std::array<double, N>;
+
+struct Chunk
+{
+    const qint64 *begin, *end;
+};
+
+struct Gradient
+{
+    Vec g{};
+    double loss = 0;
+};
+
+QTextStream out(stdout);
+
+double sigmoid(double score, double k)
+{
+    return 1.0 / (1.0 + std::pow(10.0, -k * score / 400.0));
+}
+
+Gradient gradient(const PositionFile &positions, const Chunk &chunk, const Vec &w, double k)
+{
+    Gradient res;
+    for (auto it = chunk.begin; it != chunk.end; ++it)
+    {
+        auto &position = positions[*it];
+        auto f = Evaluation::features(position.unpack());
+        double score = 0;
+        for (int i = 0; i < N; ++i)
+            score += w[i] * f[i];
+        double s = sigmoid(score, k);
+        double error = (position.result + 1) / 2.0 - s;
+        res.loss += error * error;
+        double d = -2 * error * s * (1 - s) * std::log(10.0) * k / 400.0;
+        for (int i = 0; i < N; ++i)
+            res.g[i] += d * f[i];
+    }
+    return res;
+}
+
+void addGradient(Gradient &total, const Gradient &part)
+{
+    total.loss += part.loss;
+    for (int i = 0; i < N; ++i)
+        total.g[i] += part.g[i];
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("draughts-tuner");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Fits evaluation weights to game results of a packed position file.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("positions", "Packed position file.");
+    QCommandLineOption outputOption({"o", "output"}, "Where to write the tuned weights.", "file", "weights.txt");
+    QCommandLineOption weightsOption({"w", "weights"}, "Initial weights (default: built-in).", "file");
+    QCommandLineOption epochsOption({"e", "epochs"}, "Number of passes over the positions.", "n", "10");
+    QCommandLineOption batchOption({"b", "batch"}, "Positions per gradient step.", "n", "16384");
+    QCommandLineOption rateOption({"r", "rate"}, "Learning rate, in weight units per step.", "x", "1.0");
+    QCommandLineOption kOption("k", "Sigmoid scaling constant.", "x", "1.0");
+    QCommandLineOption threadsOption({"j", "threads"}, "Worker threads.", "n", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption seedOption({"s", "seed"}, "Shuffle seed.", "n", "1");
+    parser.addOptions({outputOption, weightsOption, epochsOption, batchOption, rateOption, kOption, threadsOption, seedOption});
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    PositionFile positions(parser.positionalArguments().front());
+    if (!positions.open())
+    {
+        qCritical("Can't map %s: %s", qPrintable(parser.positionalArguments().front()), qPrintable(positions.errorString()));
+        return 1;
+    }
+    if (!positions.size())
+    {
+        qCritical("No positions");
+        return 1;
+    }
+
+    Evaluation evaluation;
+    if (parser.isSet(weightsOption) && !evaluation.load(parser.value(weightsOption)))
+    {
+        qCritical("Can't read %s", qPrintable(parser.value(weightsOption)));
+        return 1;
+    }
+
+    const int epochs = parser.value(epochsOption).toInt();
+    const qint64 batchSize = std::max(1, parser.value(batchOption).toInt());
+    const double rate = parser.value(rateOption).toDouble();
+    const double k = parser.value(kOption).toDouble();
+    const int threads = std::max(1, parser.value(threadsOption).toInt());
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+
+    Vec w, m{}, v{};
+    for (int i = 0; i < N; ++i)
+        w[i] = evaluation.weights()[i];
+    const double beta1 = 0.9, beta2 = 0.999, eps = 1e-8;
+    qint64 step = 0;
+
+    std::vector<qint64> order(positions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 rng(parser.value(seedOption).toULongLong());
+
+    out << positions.size() << " positions, " << threads << " threads\n";
+    out.flush();
+
+    for (int epoch = 1; epoch <= epochs; ++epoch)
+    {
+        QElapsedTimer timer;
+        timer.start();
+        std::shuffle(order.begin(), order.end(), rng);
+
+        double loss = 0;
+        for (qint64 b = 0; b < qint64(order.size()); b += batchSize)
+        {
+            qint64 e = std::min<qint64>(b + batchSize, order.size());
+            qint64 chunkSize = std::max<qint64>(1, (e - b + threads * 4 - 1) / (threads * 4));
+            std::vector<Chunk> chunks;
+            for (qint64 c = b; c < e; c += chunkSize)
+                chunks.push_back(Chunk{order.data() + c, order.data() + std::min(c + chunkSize, e)});
+
+            auto total = QtConcurrent::blockingMappedReduced<Gradient>(
+                chunks,
+                [&](const Chunk &chunk) { return gradient(positions, chunk, w, k); },
+                addGradient);
+            loss += total.loss;
+
+            ++step;
+            for (int i = 0; i < N; ++i)
+            {
+                if (i == Evaluation::Man) // anchors the scale of all other weights
+                    continue;
+                double g = total.g[i] / double(e - b);
+                m[i] = beta1 * m[i] + (1 - beta1) * g;
+                v[i] = beta2 * v[i] + (1 - beta2) * g * g;
+                double mHat = m[i] / (1 - std::pow(beta1, step));
+                double vHat = v[i] / (1 - std::pow(beta2, step));
+                w[i] -= rate * mHat / (std::sqrt(vHat) + eps);
+            }
+        }
+
+        qint64 elapsed = std::max<qint64>(1, timer.elapsed());
+        out << "epoch " << epoch
+            << "  loss " << QString::number(loss / double(order.size()), 'f', 6)
+            << "  time " << elapsed << " ms"
+            << "  " << qint64(order.size() * 1000.0 / elapsed) << " pos/s\n";
+        out.flush();
+    }
+
+    Evaluation::Weights tuned;
+    for (int i = 0; i < N; ++i)
+        tuned[i] = int(std::lround(w[i]));
+    evaluation.setWeights(tuned);
+    for (int i = 0; i < N; ++i)
+        out << Evaluation::featureName(i) << " " << tuned[i] << "\n";
+    out.flush();
+
+    if (!evaluation.save(parser.value(outputOption)))
+    {
+        qCritical("Can't write %s", qPrintable(parser.value(outputOption)));
+        return 1;
+    }
+    return 0;
+}